@@ -0,0 +1,202 @@
+#define _GNU_SOURCE
+#include "bench.h"
+#include "../include/malloc.h"
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+
+uint64_t bench_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+uint64_t bench_rand(uint64_t *state)
+{
+    uint64_t x = *state;
+
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *state = x;
+    return x;
+}
+
+void *bench_map(size_t size)
+{
+    void *ptr = mmap(NULL, size ? size : 1, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return ptr == MAP_FAILED ? NULL : ptr;
+}
+
+void bench_unmap(void *ptr, size_t size)
+{
+    if (ptr)
+        munmap(ptr, size ? size : 1);
+}
+
+const char *bench_allocator(void)
+{
+    return dlsym(RTLD_DEFAULT, "show_alloc_mem") ? "ft_malloc" : "system";
+}
+
+size_t bench_rss_kb(void)
+{
+    char buffer[64];
+    long pages = 0;
+    long resident = 0;
+    int fd = open("/proc/self/statm", O_RDONLY);
+
+    if (fd < 0)
+        return 0;
+    ssize_t len = read(fd, buffer, sizeof(buffer) - 1);
+    close(fd);
+    if (len <= 0)
+        return 0;
+    buffer[len] = '\0';
+    if (sscanf(buffer, "%ld %ld", &pages, &resident) != 2)
+        return 0;
+    return (size_t)resident * (size_t)sysconf(_SC_PAGESIZE) / 1024;
+}
+
+size_t bench_peak_rss_kb(void)
+{
+    struct rusage usage;
+
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+    return (size_t)usage.ru_maxrss;
+}
+
+uint64_t bench_minor_faults(void)
+{
+    struct rusage usage;
+
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+    return (uint64_t)usage.ru_minflt;
+}
+
+uint64_t bench_vm_calls(void)
+{
+    static int (*get_stats)(t_malloc_stats *) = NULL;
+    static int resolved = 0;
+    t_malloc_stats stats;
+
+    if (!resolved) {
+        get_stats = (int (*)(t_malloc_stats *))dlsym(RTLD_DEFAULT, "get_malloc_stats");
+        resolved = 1;
+    }
+    if (!get_stats || get_stats(&stats) != 0)
+        return 0;
+    return stats.mmap_calls + stats.munmap_calls + stats.madvise_calls + stats.mremap_calls;
+}
+
+int samples_init(t_samples *samples, size_t capacity)
+{
+    samples->values = bench_map(capacity * sizeof(uint64_t));
+    samples->count = 0;
+    samples->capacity = samples->values ? capacity : 0;
+    return samples->values ? 0 : -1;
+}
+
+void samples_free(t_samples *samples)
+{
+    bench_unmap(samples->values, samples->capacity * sizeof(uint64_t));
+    samples->values = NULL;
+    samples->count = 0;
+    samples->capacity = 0;
+}
+
+static void sift_down(uint64_t *values, size_t root, size_t n)
+{
+    while (root * 2 + 1 < n) {
+        size_t child = root * 2 + 1;
+        if (child + 1 < n && values[child] < values[child + 1])
+            child++;
+        if (values[root] >= values[child])
+            return;
+        uint64_t tmp = values[root];
+        values[root] = values[child];
+        values[child] = tmp;
+        root = child;
+    }
+}
+
+void samples_sort(t_samples *samples)
+{
+    uint64_t *values = samples->values;
+    size_t n = samples->count;
+
+    for (size_t i = n / 2; i > 0; i--)
+        sift_down(values, i - 1, n);
+    for (size_t end = n; end > 1; end--) {
+        uint64_t tmp = values[0];
+        values[0] = values[end - 1];
+        values[end - 1] = tmp;
+        sift_down(values, 0, end - 1);
+    }
+}
+
+void bench_result(t_bench_result *result, const char *name, uint64_t ops,
+                  uint64_t elapsed_ns, t_samples *latency)
+{
+    size_t n = latency ? latency->count : 0;
+
+    result->name = name;
+    result->ops = ops;
+    result->elapsed_ns = elapsed_ns;
+    result->p50 = 0;
+    result->p99 = 0;
+    result->p999 = 0;
+    result->max = 0;
+    result->minor_faults = 0;
+    result->vm_calls = 0;
+    if (n == 0)
+        return;
+
+    samples_sort(latency);
+    result->p50 = latency->values[n / 2];
+    result->p99 = latency->values[n * 99 / 100];
+    result->p999 = latency->values[n * 999 / 1000];
+    result->max = latency->values[n - 1];
+}
+
+void bench_print_header(void)
+{
+    printf("%-24s %12s %12s %8s %8s %8s %10s %8s %8s\n", "benchmark", "ops", "ops/sec",
+           "p50 ns", "p99 ns", "p99.9 ns", "max ns", "faults", "syscalls");
+}
+
+void bench_print(const t_bench_result *r)
+{
+    double rate = r->elapsed_ns ? (double)r->ops * 1e9 / (double)r->elapsed_ns : 0.0;
+
+    printf("%-24s %12llu %12.0f %8llu %8llu %8llu %10llu %8llu %8llu\n", r->name,
+           (unsigned long long)r->ops, rate, (unsigned long long)r->p50,
+           (unsigned long long)r->p99, (unsigned long long)r->p999,
+           (unsigned long long)r->max, (unsigned long long)r->minor_faults,
+           (unsigned long long)r->vm_calls);
+    fflush(stdout);
+}
+
+FILE *bench_results_open(const char *path)
+{
+    FILE *out = fopen(path, "a");
+
+    if (!out)
+        perror(path);
+    return out;
+}
+
+void bench_record(FILE *out, const char *name, const char *metric, double value)
+{
+    if (out)
+        fprintf(out, "%s\t%s\t%.0f\n", name, metric, value);
+}
@@ -0,0 +1,59 @@
+#ifndef BENCH_H
+# define BENCH_H
+
+# include <stddef.h>
+# include <stdint.h>
+# include <stdio.h>
+
+typedef struct s_samples {
+    uint64_t        *values;
+    size_t          count;
+    size_t          capacity;
+} t_samples;
+
+typedef struct s_bench_result {
+    const char      *name;
+    uint64_t        ops;
+    uint64_t        elapsed_ns;
+    uint64_t        p50;
+    uint64_t        p99;
+    uint64_t        p999;
+    uint64_t        max;
+    uint64_t        minor_faults;
+    uint64_t        vm_calls;
+} t_bench_result;
+
+uint64_t    bench_now(void);
+uint64_t    bench_rand(uint64_t *state);
+void        *bench_map(size_t size);
+void        bench_unmap(void *ptr, size_t size);
+const char  *bench_allocator(void);
+size_t      bench_rss_kb(void);
+size_t      bench_peak_rss_kb(void);
+uint64_t    bench_minor_faults(void);
+uint64_t    bench_vm_calls(void);
+
+int         samples_init(t_samples *samples, size_t capacity);
+void        samples_free(t_samples *samples);
+void        samples_sort(t_samples *samples);
+
+void        bench_result(t_bench_result *result, const char *name, uint64_t ops,
+                         uint64_t elapsed_ns, t_samples *latency);
+void        bench_print_header(void);
+void        bench_print(const t_bench_result *result);
+FILE        *bench_results_open(const char *path);
+void        bench_record(FILE *out, const char *name, const char *metric, double value);
+
+# define BENCH_TIMED(lat, expr) do { \
+        if (lat) { \
+            uint64_t bench_t0_ = bench_now(); \
+            expr; \
+            uint64_t bench_t1_ = bench_now(); \
+            if ((lat)->count < (lat)->capacity) \
+                (lat)->values[(lat)->count++] = bench_t1_ - bench_t0_; \
+        } else { \
+            expr; \
+        } \
+    } while (0)
+
+#endif
@@ -0,0 +1,202 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_RESULTS 256
+#define MAX_RUNS 32
+#define MAX_OVERRIDES 8
+#define NAME_MAX_LEN 64
+
+typedef struct s_result {
+    char            name[NAME_MAX_LEN];
+    char            metric[NAME_MAX_LEN];
+    double          value;
+    double          runs[MAX_RUNS];
+    size_t          run_count;
+} t_result;
+
+typedef struct s_results {
+    t_result        items[MAX_RESULTS];
+    size_t          count;
+} t_results;
+
+typedef struct s_tolerance {
+    double          fallback;
+    char            metric[MAX_OVERRIDES][NAME_MAX_LEN];
+    double          percent[MAX_OVERRIDES];
+    size_t          count;
+} t_tolerance;
+
+static int higher_is_better(const char *metric)
+{
+    return strcmp(metric, "ops_per_sec") == 0;
+}
+
+static t_result *find_result(t_results *results, const char *name, const char *metric)
+{
+    for (size_t i = 0; i < results->count; i++) {
+        if (strcmp(results->items[i].name, name) == 0 &&
+            strcmp(results->items[i].metric, metric) == 0)
+            return &results->items[i];
+    }
+    return NULL;
+}
+
+static void add_run(t_results *results, const char *name, const char *metric, double value)
+{
+    t_result *result = find_result(results, name, metric);
+
+    if (!result) {
+        if (results->count == MAX_RESULTS)
+            return;
+        result = &results->items[results->count++];
+        snprintf(result->name, sizeof(result->name), "%s", name);
+        snprintf(result->metric, sizeof(result->metric), "%s", metric);
+        result->run_count = 0;
+    }
+    if (result->run_count < MAX_RUNS)
+        result->runs[result->run_count++] = value;
+}
+
+static double median(double *runs, size_t count)
+{
+    for (size_t i = 1; i < count; i++) {
+        double value = runs[i];
+        size_t j = i;
+
+        while (j > 0 && runs[j - 1] > value) {
+            runs[j] = runs[j - 1];
+            j--;
+        }
+        runs[j] = value;
+    }
+    if (count % 2)
+        return runs[count / 2];
+    return (runs[count / 2 - 1] + runs[count / 2]) / 2.0;
+}
+
+static int load_results(const char *path, t_results *results)
+{
+    char line[256];
+    char name[NAME_MAX_LEN];
+    char metric[NAME_MAX_LEN];
+    double value;
+    FILE *file = fopen(path, "r");
+
+    if (!file) {
+        perror(path);
+        return -1;
+    }
+    results->count = 0;
+    while (fgets(line, sizeof(line), file)) {
+        if (line[0] == '#' || line[0] == '\n')
+            continue;
+        if (sscanf(line, "%63[^\t]\t%63[^\t]\t%lf", name, metric, &value) != 3) {
+            fprintf(stderr, "%s: malformed line: %s", path, line);
+            fclose(file);
+            return -1;
+        }
+        add_run(results, name, metric, value);
+    }
+    fclose(file);
+    for (size_t i = 0; i < results->count; i++)
+        results->items[i].value = median(results->items[i].runs, results->items[i].run_count);
+    return 0;
+}
+
+static int parse_tolerances(int argc, char **argv, t_tolerance *tolerance)
+{
+    tolerance->fallback = 10.0;
+    tolerance->count = 0;
+    for (int i = 3; i < argc; i++) {
+        char *eq = strchr(argv[i], '=');
+        char *end;
+        double percent = strtod(eq ? eq + 1 : argv[i], &end);
+
+        if (*end != '\0' || percent < 0.0)
+            return -1;
+        if (!eq) {
+            tolerance->fallback = percent;
+            continue;
+        }
+        if (tolerance->count == MAX_OVERRIDES || (size_t)(eq - argv[i]) >= NAME_MAX_LEN)
+            return -1;
+        snprintf(tolerance->metric[tolerance->count], NAME_MAX_LEN, "%.*s",
+                 (int)(eq - argv[i]), argv[i]);
+        tolerance->percent[tolerance->count++] = percent;
+    }
+    return 0;
+}
+
+static double tolerance_for(const t_tolerance *tolerance, const char *metric)
+{
+    for (size_t i = 0; i < tolerance->count; i++) {
+        if (strcmp(tolerance->metric[i], metric) == 0)
+            return tolerance->percent[i];
+    }
+    return tolerance->fallback;
+}
+
+static int compare(const t_result *base, t_results *current, const t_tolerance *tolerance)
+{
+    t_result *now = find_result(current, base->name, base->metric);
+    double limit = tolerance_for(tolerance, base->metric);
+
+    if (!now) {
+        printf("%-24s %-12s %12.0f %12s %8s %7.1f%%  MISSING\n", base->name, base->metric,
+               base->value, "-", "-", limit);
+        return 1;
+    }
+
+    double worse = 0.0;
+    if (base->value > 0.0) {
+        worse = (now->value - base->value) / base->value * 100.0;
+        if (higher_is_better(base->metric))
+            worse = -worse;
+    }
+    int regressed = worse > limit;
+    printf("%-24s %-12s %12.0f %12.0f %+7.1f%% %7.1f%%  %s\n", base->name, base->metric,
+           base->value, now->value, worse, limit, regressed ? "REGRESSION" : "ok");
+    return regressed;
+}
+
+static int print_medians(const char *path, t_results *results)
+{
+    if (load_results(path, results) != 0)
+        return 2;
+    for (size_t i = 0; i < results->count; i++)
+        printf("%s\t%s\t%.0f\n", results->items[i].name, results->items[i].metric,
+               results->items[i].value);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    static t_results baseline;
+    static t_results current;
+    t_tolerance tolerance;
+    int regressions = 0;
+
+    if (argc == 2)
+        return print_medians(argv[1], &current);
+    if (argc < 3 || parse_tolerances(argc, argv, &tolerance) != 0) {
+        fprintf(stderr, "usage: %s results.tsv\n"
+                "       %s baseline.tsv current.tsv [percent] [metric=percent ...]\n",
+                argv[0], argv[0]);
+        return 2;
+    }
+    if (load_results(argv[1], &baseline) != 0 || load_results(argv[2], &current) != 0)
+        return 2;
+
+    printf("%-24s %-12s %12s %12s %8s %8s\n", "benchmark", "metric", "baseline", "current",
+           "worse", "allowed");
+    for (size_t i = 0; i < baseline.count; i++)
+        regressions += compare(&baseline.items[i], &current, &tolerance);
+
+    if (regressions) {
+        printf("%d of %zu metrics regressed\n", regressions, baseline.count);
+        return 1;
+    }
+    printf("no regressions in %zu metrics\n", baseline.count);
+    return 0;
+}
@@ -0,0 +1,178 @@
+#define _GNU_SOURCE
+#include "bench.h"
+#include "../include/malloc.h"
+#include <dlfcn.h>
+#include <malloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_SLOTS 4096
+#define PHASE_COUNT 5
+#define SAMPLES 200
+
+typedef struct s_phase {
+    const char      *name;
+    size_t          slots;
+    size_t          min_size;
+    size_t          max_size;
+    uint64_t        weight;
+    int             scaled;
+} t_phase;
+
+typedef struct s_object {
+    void            *ptr;
+    size_t          size;
+} t_object;
+
+typedef struct s_run {
+    t_object        objects[MAX_SLOTS];
+    size_t          live_bytes;
+    size_t          live_objects;
+    uint64_t        ops;
+    uint64_t        failed;
+    uint64_t        start;
+    size_t          peak_rss_kb;
+    FILE            *csv;
+} t_run;
+
+static const t_phase g_phases[PHASE_COUNT] = {
+    {"burst-small", 256, 16, 128, 3, 0},
+    {"steady-mixed", 4096, 16, 1024, 4, 0},
+    {"large", 64, 64 * 1024, 1024 * 1024, 1, 1},
+    {"shift-up", 2048, 256, 1024, 2, 0},
+    {"idle", 0, 0, 0, 0, 0},
+};
+
+static size_t allocator_mapped_kb(void)
+{
+    static int (*get_stats)(t_malloc_stats *) = NULL;
+    static int resolved = 0;
+    t_malloc_stats stats;
+
+    if (!resolved) {
+        get_stats = (int (*)(t_malloc_stats *))dlsym(RTLD_DEFAULT, "get_malloc_stats");
+        resolved = 1;
+    }
+    if (get_stats && get_stats(&stats) == 0)
+        return (stats.bytes_mapped + stats.pool_bytes_mapped) / 1024;
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+    struct mallinfo2 info = mallinfo2();
+    return (info.arena + info.hblkhd) / 1024;
+#else
+    return 0;
+#endif
+}
+
+static void sample(t_run *run, const char *phase)
+{
+    size_t rss = bench_rss_kb();
+
+    if (rss > run->peak_rss_kb)
+        run->peak_rss_kb = rss;
+    fprintf(run->csv, "%s,%llu,%s,%zu,%zu,%zu,%zu,%.1f\n", bench_allocator(),
+            (unsigned long long)run->ops, phase, run->live_objects, run->live_bytes / 1024,
+            allocator_mapped_kb(), rss, (double)(bench_now() - run->start) / 1e6);
+}
+
+static void release(t_run *run, t_object *object)
+{
+    if (!object->ptr)
+        return;
+    free(object->ptr);
+    run->live_bytes -= object->size;
+    run->live_objects--;
+    object->ptr = NULL;
+}
+
+static void step(t_run *run, const t_phase *phase, size_t scale, uint64_t *seed)
+{
+    t_object *object = &run->objects[bench_rand(seed) % phase->slots];
+    size_t range = phase->max_size - phase->min_size + 1;
+    size_t size = (phase->min_size + bench_rand(seed) % range) * scale;
+
+    release(run, object);
+    object->ptr = malloc(size);
+    if (object->ptr) {
+        memset(object->ptr, 1, size < 256 ? size : 256);
+        object->size = size;
+        run->live_bytes += size;
+        run->live_objects++;
+    } else {
+        run->failed++;
+    }
+    run->ops++;
+}
+
+static void idle(t_run *run, uint64_t *seed)
+{
+    for (size_t i = 0; i < MAX_SLOTS; i++) {
+        if (bench_rand(seed) % 10 != 0)
+            release(run, &run->objects[i]);
+    }
+}
+
+static void run_phases(t_run *run, uint64_t total_ops)
+{
+    uint64_t seed = 0x853C49E6748FEA9BULL;
+    uint64_t period = total_ops / SAMPLES ? total_ops / SAMPLES : 1;
+    uint64_t cycle_ops = total_ops / 8 ? total_ops / 8 : 1;
+    size_t cycle = 0;
+
+    while (run->ops < total_ops) {
+        for (int p = 0; p < PHASE_COUNT && run->ops < total_ops; p++) {
+            const t_phase *phase = &g_phases[p];
+            uint64_t end = run->ops + cycle_ops * phase->weight / 10;
+
+            if (phase->slots == 0) {
+                idle(run, &seed);
+                sample(run, phase->name);
+                continue;
+            }
+            while (run->ops < end && run->ops < total_ops) {
+                step(run, phase, phase->scaled ? 1 + cycle % 3 : 1, &seed);
+                if (run->ops % period == 0)
+                    sample(run, phase->name);
+            }
+        }
+        cycle++;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    static t_run run;
+    uint64_t total_ops = argc > 1 ? strtoull(argv[1], NULL, 10) : 2000000;
+
+    if (argc > 4 || total_ops == 0) {
+        fprintf(stderr, "usage: %s [operations] [output.csv] [results.tsv]\n", argv[0]);
+        return 2;
+    }
+
+    run.csv = argc > 2 ? fopen(argv[2], "w") : stdout;
+    if (!run.csv) {
+        perror(argv[2]);
+        return 1;
+    }
+
+    run.start = bench_now();
+    fprintf(run.csv, "allocator,ops,phase,live_objects,live_kb,allocator_kb,rss_kb,elapsed_ms\n");
+    run_phases(&run, total_ops);
+    for (size_t i = 0; i < MAX_SLOTS; i++)
+        release(&run, &run.objects[i]);
+    sample(&run, "end");
+
+    fprintf(stderr, "%s: %llu ops in %.1f s, %llu failed, peak RSS %zu KB, final RSS %zu KB\n",
+            bench_allocator(), (unsigned long long)run.ops,
+            (double)(bench_now() - run.start) / 1e9, (unsigned long long)run.failed,
+            run.peak_rss_kb, bench_rss_kb());
+    if (run.csv != stdout)
+        fclose(run.csv);
+
+    FILE *results = argc > 3 ? bench_results_open(argv[3]) : NULL;
+    if (!results)
+        return argc > 3;
+    bench_record(results, "rss phased", "peak_rss_kb", (double)run.peak_rss_kb);
+    fclose(results);
+    return 0;
+}
@@ -0,0 +1,208 @@
+#define _GNU_SOURCE
+#include "bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BATCH 256
+#define MIXED_SLOTS 1024
+#define SIZE_CLASSES 7
+
+typedef struct s_workload {
+    char            name[32];
+    uint64_t        (*run)(const struct s_workload *w, t_samples *lat);
+    size_t          size;
+    uint64_t        ops;
+} t_workload;
+
+static void *g_slots[MIXED_SLOTS];
+
+static uint64_t run_size_class(const t_workload *w, t_samples *lat)
+{
+    uint64_t ops = 0;
+
+    while (ops < w->ops) {
+        for (int i = 0; i < BATCH; i++) {
+            BENCH_TIMED(lat, g_slots[i] = malloc(w->size));
+            if (g_slots[i])
+                ((volatile char *)g_slots[i])[0] = 1;
+        }
+        for (int i = BATCH - 1; i >= 0; i--)
+            BENCH_TIMED(lat, free(g_slots[i]));
+        ops += BATCH * 2;
+    }
+    return ops;
+}
+
+static uint64_t run_realloc_linear(const t_workload *w, t_samples *lat)
+{
+    uint64_t ops = 0;
+
+    while (ops < w->ops) {
+        void *ptr = NULL;
+        for (size_t size = 16; size <= w->size; size += 16) {
+            void *next;
+            BENCH_TIMED(lat, next = realloc(ptr, size));
+            if (!next)
+                break;
+            ptr = next;
+            ((volatile char *)ptr)[size - 1] = 1;
+            ops++;
+        }
+        free(ptr);
+    }
+    return ops;
+}
+
+static uint64_t run_realloc_double(const t_workload *w, t_samples *lat)
+{
+    uint64_t ops = 0;
+
+    while (ops < w->ops) {
+        void *ptr = NULL;
+        for (size_t size = 16; size <= w->size; size *= 2) {
+            void *next;
+            BENCH_TIMED(lat, next = realloc(ptr, size));
+            if (!next)
+                break;
+            ptr = next;
+            ((volatile char *)ptr)[size - 1] = 1;
+            ops++;
+        }
+        free(ptr);
+    }
+    return ops;
+}
+
+static uint64_t run_large_churn(const t_workload *w, t_samples *lat)
+{
+    uint64_t seed = 0x9E3779B97F4A7C15ULL;
+    uint64_t ops = 0;
+
+    while (ops < w->ops) {
+        size_t size = w->size + bench_rand(&seed) % (w->size * 7);
+        void *ptr;
+        BENCH_TIMED(lat, ptr = malloc(size));
+        if (ptr)
+            ((volatile char *)ptr)[0] = 1;
+        BENCH_TIMED(lat, free(ptr));
+        ops += 2;
+    }
+    return ops;
+}
+
+static size_t mixed_size(uint64_t *seed)
+{
+    uint64_t roll = bench_rand(seed) % 100;
+
+    if (roll < 80)
+        return 1 + bench_rand(seed) % 128;
+    if (roll < 95)
+        return 129 + bench_rand(seed) % 896;
+    return 1025 + bench_rand(seed) % (64 * 1024);
+}
+
+static uint64_t run_mixed(const t_workload *w, t_samples *lat)
+{
+    uint64_t seed = 0xD1B54A32D192ED03ULL;
+    uint64_t ops = 0;
+
+    memset(g_slots, 0, sizeof(g_slots));
+    while (ops < w->ops) {
+        size_t slot = bench_rand(&seed) % MIXED_SLOTS;
+        uint64_t roll = bench_rand(&seed) % 10;
+        size_t size = mixed_size(&seed);
+
+        if (g_slots[slot] && roll == 0) {
+            void *next;
+            BENCH_TIMED(lat, next = realloc(g_slots[slot], size));
+            if (next)
+                g_slots[slot] = next;
+        } else if (g_slots[slot]) {
+            BENCH_TIMED(lat, free(g_slots[slot]));
+            g_slots[slot] = NULL;
+        } else {
+            BENCH_TIMED(lat, g_slots[slot] = malloc(size));
+            if (g_slots[slot])
+                ((volatile char *)g_slots[slot])[0] = 1;
+        }
+        ops++;
+    }
+    for (size_t i = 0; i < MIXED_SLOTS; i++)
+        free(g_slots[i]);
+    return ops;
+}
+
+static size_t build_workloads(t_workload *w, uint64_t scale)
+{
+    static const size_t sizes[SIZE_CLASSES] = {16, 64, 128, 256, 1024, 4096, 65536};
+    size_t n = 0;
+
+    for (int i = 0; i < SIZE_CLASSES; i++, n++) {
+        snprintf(w[n].name, sizeof(w[n].name), "malloc/free %zu", sizes[i]);
+        w[n].run = run_size_class;
+        w[n].size = sizes[i];
+        w[n].ops = (sizes[i] > 1024 ? 20000 : 200000) * scale;
+    }
+    w[n++] = (t_workload){"realloc grow +16", run_realloc_linear, 4096, 50000 * scale};
+    w[n++] = (t_workload){"realloc grow x2", run_realloc_double, 1 << 20, 20000 * scale};
+    w[n++] = (t_workload){"large churn", run_large_churn, 128 * 1024, 20000 * scale};
+    w[n++] = (t_workload){"mixed random", run_mixed, 0, 200000 * scale};
+    return n;
+}
+
+static int run_workload(const t_workload *w, t_bench_result *result)
+{
+    t_samples lat;
+    uint64_t faults = bench_minor_faults();
+    uint64_t vm_calls = bench_vm_calls();
+
+    uint64_t start = bench_now();
+    uint64_t ops = w->run(w, NULL);
+    uint64_t elapsed = bench_now() - start;
+    faults = bench_minor_faults() - faults;
+    vm_calls = bench_vm_calls() - vm_calls;
+
+    if (samples_init(&lat, ops + BATCH * 2) != 0)
+        return -1;
+    w->run(w, &lat);
+    bench_result(result, w->name, ops, elapsed, &lat);
+    result->minor_faults = faults;
+    result->vm_calls = vm_calls;
+    samples_free(&lat);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    t_workload workloads[SIZE_CLASSES + 4];
+    t_bench_result result;
+    FILE *results = NULL;
+    uint64_t scale = 1;
+
+    if (argc > 3 || (argc >= 2 && (scale = strtoull(argv[1], NULL, 10)) == 0)) {
+        fprintf(stderr, "usage: %s [scale] [results.tsv]\n", argv[0]);
+        return 2;
+    }
+    if (argc == 3 && !(results = bench_results_open(argv[2])))
+        return 1;
+
+    size_t count = build_workloads(workloads, scale);
+    printf("allocator: %s, single thread, scale %llu\n", bench_allocator(),
+           (unsigned long long)scale);
+    bench_print_header();
+    for (size_t i = 0; i < count; i++) {
+        if (run_workload(&workloads[i], &result) != 0) {
+            fprintf(stderr, "bench: out of memory\n");
+            return 1;
+        }
+        bench_print(&result);
+        bench_record(results, result.name, "ops_per_sec",
+                     (double)result.ops * 1e9 / (double)(result.elapsed_ns ? result.elapsed_ns : 1));
+        bench_record(results, result.name, "p99_ns", (double)result.p99);
+    }
+    bench_record(results, "single-thread suite", "peak_rss_kb", (double)bench_peak_rss_kb());
+    if (results)
+        fclose(results);
+    return 0;
+}
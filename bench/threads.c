@@ -0,0 +1,280 @@
+#define _GNU_SOURCE
+#include "bench.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_THREADS 64
+#define THREADTEST_BATCH 100
+#define LARSON_LIVE 2048
+#define LARSON_GENERATIONS 4
+#define RING_SIZE 1024
+#define FALSE_SHARING_WRITES 1000
+
+typedef struct s_ring {
+    void            *items[RING_SIZE];
+    size_t          head __attribute__((aligned(64)));
+    size_t          tail __attribute__((aligned(64)));
+} t_ring;
+
+typedef struct s_worker {
+    int             id;
+    int             threads;
+    uint64_t        ops;
+    uint64_t        done;
+    void            **slots;
+    size_t          slot_count;
+    t_ring          *ring;
+    void            *handoff;
+    pthread_barrier_t *barrier;
+} t_worker;
+
+typedef struct s_mt_bench {
+    const char      *name;
+    void            *(*run)(void *arg);
+    uint64_t        ops;
+} t_mt_bench;
+
+static void touch(void *ptr, size_t size)
+{
+    if (ptr)
+        memset(ptr, 0xA5, size < 64 ? size : 64);
+}
+
+static void *threadtest_worker(void *arg)
+{
+    t_worker *w = arg;
+    void *batch[THREADTEST_BATCH];
+
+    pthread_barrier_wait(w->barrier);
+    while (w->done < w->ops) {
+        for (int i = 0; i < THREADTEST_BATCH; i++) {
+            batch[i] = malloc(8 + (size_t)(i % 8) * 8);
+            touch(batch[i], 8);
+        }
+        for (int i = 0; i < THREADTEST_BATCH; i++)
+            free(batch[i]);
+        w->done += THREADTEST_BATCH * 2;
+    }
+    return NULL;
+}
+
+static void *larson_worker(void *arg)
+{
+    t_worker *w = arg;
+    uint64_t seed = 0x2545F4914F6CDD1DULL * (uint64_t)(w->id + 1);
+
+    pthread_barrier_wait(w->barrier);
+    while (w->done < w->ops) {
+        size_t slot = bench_rand(&seed) % w->slot_count;
+        size_t size = 16 + bench_rand(&seed) % 113;
+
+        free(w->slots[slot]);
+        w->slots[slot] = malloc(size);
+        touch(w->slots[slot], size);
+        w->done += 2;
+    }
+    return NULL;
+}
+
+static void ring_push(t_ring *ring, void *ptr)
+{
+    size_t head = ring->head;
+
+    while (head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) >= RING_SIZE)
+        sched_yield();
+    ring->items[head % RING_SIZE] = ptr;
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+}
+
+static void *ring_pop(t_ring *ring)
+{
+    size_t tail = ring->tail;
+
+    while (__atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) == tail)
+        sched_yield();
+    void *ptr = ring->items[tail % RING_SIZE];
+    __atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+    return ptr;
+}
+
+static void *prodcons_worker(void *arg)
+{
+    t_worker *w = arg;
+    int producer = w->id % 2 == 0;
+
+    pthread_barrier_wait(w->barrier);
+    while (w->done < w->ops) {
+        if (producer) {
+            void *ptr = malloc(16 + (w->done % 16) * 16);
+            touch(ptr, 16);
+            ring_push(w->ring, ptr);
+        } else {
+            free(ring_pop(w->ring));
+        }
+        w->done++;
+    }
+    return NULL;
+}
+
+static void write_object(volatile char *object)
+{
+    for (int i = 0; i < FALSE_SHARING_WRITES; i++)
+        object[i % 8] = (char)i;
+}
+
+static void *active_false_worker(void *arg)
+{
+    t_worker *w = arg;
+
+    pthread_barrier_wait(w->barrier);
+    while (w->done < w->ops) {
+        char *object = malloc(8);
+        if (object)
+            write_object(object);
+        free(object);
+        w->done += 2;
+    }
+    return NULL;
+}
+
+static void *passive_false_worker(void *arg)
+{
+    t_worker *w = arg;
+
+    pthread_barrier_wait(w->barrier);
+    free(w->handoff);
+    while (w->done < w->ops) {
+        char *object = malloc(8);
+        if (object)
+            write_object(object);
+        free(object);
+        w->done += 2;
+    }
+    return NULL;
+}
+
+static int setup_workers(const t_mt_bench *bench, t_worker *workers, int threads,
+                         pthread_barrier_t *barrier)
+{
+    t_ring *rings = NULL;
+
+    if (bench->run == prodcons_worker) {
+        rings = bench_map(sizeof(t_ring) * (size_t)(threads / 2 + 1));
+        if (!rings)
+            return -1;
+    }
+
+    memset(workers, 0, sizeof(t_worker) * (size_t)threads);
+    for (int i = 0; i < threads; i++) {
+        workers[i].id = i;
+        workers[i].threads = threads;
+        workers[i].ops = bench->ops / (uint64_t)threads;
+        workers[i].barrier = barrier;
+        workers[i].ring = rings ? &rings[i / 2] : NULL;
+        if (bench->run == larson_worker) {
+            workers[i].slot_count = LARSON_LIVE / (size_t)threads;
+            workers[i].slots = bench_map(workers[i].slot_count * sizeof(void *));
+        }
+        if (bench->run == passive_false_worker)
+            workers[i].handoff = malloc(8);
+    }
+    return 0;
+}
+
+static void teardown_workers(const t_mt_bench *bench, t_worker *workers, int threads)
+{
+    for (int i = 0; i < threads; i++) {
+        for (size_t s = 0; workers[i].slots && s < workers[i].slot_count; s++)
+            free(workers[i].slots[s]);
+        bench_unmap(workers[i].slots, workers[i].slot_count * sizeof(void *));
+    }
+    if (bench->run == prodcons_worker)
+        bench_unmap(workers[0].ring, sizeof(t_ring) * (size_t)(threads / 2 + 1));
+}
+
+static uint64_t run_generation(const t_mt_bench *bench, t_worker *workers, int threads,
+                               pthread_barrier_t *barrier)
+{
+    pthread_t tids[MAX_THREADS];
+
+    for (int i = 0; i < threads; i++) {
+        workers[i].done = 0;
+        pthread_create(&tids[i], NULL, bench->run, &workers[i]);
+    }
+    pthread_barrier_wait(barrier);
+    uint64_t start = bench_now();
+    for (int i = 0; i < threads; i++)
+        pthread_join(tids[i], NULL);
+    return bench_now() - start;
+}
+
+static double run_bench(const t_mt_bench *bench, int threads)
+{
+    t_worker workers[MAX_THREADS];
+    pthread_barrier_t barrier;
+    uint64_t elapsed = 0;
+    uint64_t ops = 0;
+
+    pthread_barrier_init(&barrier, NULL, (unsigned)threads + 1);
+    if (setup_workers(bench, workers, threads, &barrier) != 0)
+        return 0.0;
+
+    int generations = bench->run == larson_worker ? LARSON_GENERATIONS : 1;
+    for (int g = 0; g < generations; g++) {
+        elapsed += run_generation(bench, workers, threads, &barrier);
+        for (int i = 0; i < threads; i++)
+            ops += workers[i].done;
+    }
+
+    teardown_workers(bench, workers, threads);
+    pthread_barrier_destroy(&barrier);
+    return elapsed ? (double)ops * 1e9 / (double)elapsed : 0.0;
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t scale = argc > 2 ? strtoull(argv[2], NULL, 10) : 1;
+    int max_threads = argc > 1 ? atoi(argv[1]) : MAX_THREADS;
+    FILE *results = NULL;
+    char label[64];
+    t_mt_bench benches[] = {
+        {"threadtest", threadtest_worker, 2000000 * scale},
+        {"larson", larson_worker, 200000 * scale},
+        {"producer-consumer", prodcons_worker, 500000 * scale},
+        {"active-false", active_false_worker, 200000 * scale},
+        {"passive-false", passive_false_worker, 200000 * scale},
+    };
+
+    if (argc > 4 || max_threads < 1 || max_threads > MAX_THREADS || scale == 0) {
+        fprintf(stderr, "usage: %s [max_threads<=%d] [scale] [results.tsv]\n", argv[0],
+                MAX_THREADS);
+        return 2;
+    }
+    if (argc == 4 && !(results = bench_results_open(argv[3])))
+        return 1;
+
+    printf("allocator: %s, up to %d threads, scale %llu\n", bench_allocator(),
+           max_threads, (unsigned long long)scale);
+    printf("%-20s %8s %14s %8s\n", "benchmark", "threads", "ops/sec", "speedup");
+    for (size_t b = 0; b < sizeof(benches) / sizeof(benches[0]); b++) {
+        double base = 0.0;
+        for (int threads = 1; threads <= max_threads; threads *= 2) {
+            if (benches[b].run == prodcons_worker && threads == 1)
+                continue;
+            double rate = run_bench(&benches[b], threads);
+            if (base == 0.0)
+                base = rate;
+            printf("%-20s %8d %14.0f %7.2fx\n", benches[b].name, threads, rate,
+                   base > 0.0 ? rate / base : 0.0);
+            fflush(stdout);
+            snprintf(label, sizeof(label), "%s x%d", benches[b].name, threads);
+            bench_record(results, label, "ops_per_sec", rate);
+        }
+    }
+    if (results)
+        fclose(results);
+    return 0;
+}
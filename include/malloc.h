@@ -20,6 +20,8 @@ void    free(void *ptr);
 void    *malloc(size_t size);
 void    *realloc(void *ptr, size_t size);
 void    show_alloc_mem(void);
+void    *malloc_aligned(size_t alignment, size_t size);
+void    free_sized(void *ptr, size_t size);
 int     malloc_validate_system(void);
 
 typedef struct s_malloc_stats {
@@ -35,11 +37,303 @@ typedef struct s_malloc_stats {
     uint32_t        corruption_count;
     double          fragmentation;
     uint64_t        update_time;
+    uint32_t        pools_active;
+    uint32_t        pool_slabs;
+    size_t          pool_objects_in_use;
+    size_t          pool_bytes_mapped;
+    uint32_t        zones_by_type[3];
+    size_t          reuse_hits;
+    size_t          reuse_misses;
+    size_t          bytes_mapped;
+    size_t          mmap_calls;
+    size_t          mmap_bytes;
+    size_t          munmap_calls;
+    size_t          munmap_bytes;
+    size_t          madvise_calls;
+    size_t          madvise_bytes;
+    size_t          mremap_calls;
+    size_t          mremap_bytes;
+    size_t          minor_faults;
+    size_t          major_faults;
+    size_t          hook_events_dropped;
 } t_malloc_stats;
 
+# define MALLOC_STATS_SHM_ENV "MALLOC_STATS_SHM"
+# define MALLOC_STATS_SHM_MAGIC "FTSTATPG"
+# define MALLOC_STATS_SHM_VERSION 1
+
+typedef struct s_malloc_stats_page {
+    char            magic[8];
+    uint32_t        version;
+    uint32_t        size;
+    uint64_t        sequence;
+    uint64_t        pid;
+    uint64_t        start_time;
+    uint64_t        bytes_allocated;
+    uint64_t        bytes_peak;
+    uint64_t        bytes_mapped;
+    uint64_t        zones_active;
+    uint64_t        zones_by_type[3];
+    uint64_t        mmap_calls;
+    uint64_t        munmap_calls;
+    uint64_t        reuse_hits;
+    uint64_t        reuse_misses;
+    uint64_t        errors_count;
+} t_malloc_stats_page;
+
+int     malloc_stats_shm_start(const char *name);
+int     malloc_stats_shm_stop(void);
+
+typedef enum {
+    MALLOC_DUMP_TEXT = 0,
+    MALLOC_DUMP_JSON = 1,
+    MALLOC_DUMP_BINARY = 2
+} t_malloc_dump_format;
+
+# define MALLOC_DUMP_MAGIC "FTMALLOC"
+# define MALLOC_DUMP_VERSION 1
+# define MALLOC_DUMP_ZONE 0
+# define MALLOC_DUMP_CHUNK 1
+
+typedef struct s_malloc_dump_header {
+    char            magic[8];
+    uint32_t        version;
+    uint32_t        record_size;
+    uint64_t        record_count;
+    uint64_t        total;
+} t_malloc_dump_header;
+
+typedef struct s_malloc_dump_record {
+    uint64_t        start;
+    uint64_t        size;
+    uint32_t        type;
+    uint32_t        kind;
+} t_malloc_dump_record;
+
+int     show_alloc_mem_fd(int fd, t_malloc_dump_format format);
+
+# define MALLOC_SIZE_CLASSES 48
+
+# define MALLOC_HEAP_MAGIC "FTHEAPSN"
+# define MALLOC_HEAP_VERSION 1
+
+typedef struct s_malloc_heap_header {
+    char            magic[8];
+    uint32_t        version;
+    uint32_t        record_size;
+    uint64_t        record_count;
+    uint64_t        live_bytes;
+    uint64_t        timestamp;
+    uint64_t        class_max[MALLOC_SIZE_CLASSES];
+} t_malloc_heap_header;
+
+typedef struct s_malloc_heap_record {
+    uint64_t        address;
+    uint64_t        size;
+    uint64_t        site;
+    uint16_t        type;
+    uint16_t        size_class;
+    uint32_t        slack;
+} t_malloc_heap_record;
+
+int     heap_snapshot(int fd);
+
+typedef struct s_malloc_size_class {
+    size_t          size_max;
+    size_t          count;
+    size_t          allocs;
+    size_t          frees;
+    size_t          bytes_in_use;
+    size_t          bytes_wasted;
+} t_malloc_size_class;
+
+# define MALLOC_LATENCY_BUCKETS 64
+# define MALLOC_LATENCY_OPS 3
+
+typedef enum {
+    MALLOC_OP_MALLOC = 0,
+    MALLOC_OP_FREE = 1,
+    MALLOC_OP_REALLOC = 2
+} t_malloc_op;
+
+# define MALLOC_TRACE_ENV "MALLOC_TRACE_FILE"
+# define MALLOC_TRACE_MAGIC "FTTRACE1"
+# define MALLOC_TRACE_VERSION 1
+
+typedef struct s_malloc_trace_header {
+    char            magic[8];
+    uint32_t        version;
+    uint32_t        record_size;
+} t_malloc_trace_header;
+
+typedef struct s_malloc_trace_record {
+    uint64_t        timestamp;
+    uint64_t        ptr;
+    uint64_t        old_ptr;
+    uint64_t        size;
+    uint32_t        thread;
+    uint32_t        op;
+} t_malloc_trace_record;
+
+int     malloc_trace_start(const char *path);
+int     malloc_trace_stop(void);
+
+typedef struct s_malloc_latency_hist {
+    uint64_t        count;
+    uint64_t        total;
+    uint64_t        max;
+    uint64_t        mmap_calls;
+    uint64_t        munmap_calls;
+    uint64_t        buckets[MALLOC_LATENCY_BUCKETS];
+} t_malloc_latency_hist;
+
+typedef struct s_malloc_latency {
+    int                     unit_cycles;
+    t_malloc_latency_hist   ops[MALLOC_LATENCY_OPS][3];
+} t_malloc_latency;
+
+# define MALLOC_LOCK_SITES 11
+
+typedef enum {
+    MALLOC_LOCK_MALLOC = 0,
+    MALLOC_LOCK_FREE = 1,
+    MALLOC_LOCK_REALLOC = 2,
+    MALLOC_LOCK_ALIGNED = 3,
+    MALLOC_LOCK_POOL_ZONE = 4,
+    MALLOC_LOCK_CONFIG = 5,
+    MALLOC_LOCK_MAINTENANCE = 6,
+    MALLOC_LOCK_POOL = 7,
+    MALLOC_LOCK_PROF = 8,
+    MALLOC_LOCK_TRACE = 9,
+    MALLOC_LOCK_HOOKS = 10
+} t_malloc_lock_site;
+
+typedef struct s_malloc_lock_site_stats {
+    uint64_t        acquisitions;
+    uint64_t        contended;
+    uint64_t        wait_ns;
+    uint64_t        wait_max_ns;
+    uint64_t        held_while_contended;
+} t_malloc_lock_site_stats;
+
+typedef struct s_malloc_lock_stats {
+    uint64_t                    acquisitions;
+    uint64_t                    contended;
+    uint64_t                    wait_ns;
+    t_malloc_lock_site_stats    sites[MALLOC_LOCK_SITES];
+} t_malloc_lock_stats;
+
+# define MALLOC_FRAG_BUCKETS 16
+
+typedef struct s_malloc_zone_frag {
+    uint64_t        start;
+    uint32_t        type;
+    uint32_t        chunks;
+    size_t          total_size;
+    size_t          used_size;
+    size_t          allocated_bytes;
+    size_t          free_bytes;
+    size_t          free_runs;
+    size_t          largest_free_run;
+    size_t          bump_remaining;
+    double          external_fragmentation;
+} t_malloc_zone_frag;
+
+typedef struct s_malloc_frag_report {
+    size_t          zones;
+    size_t          free_bytes;
+    size_t          free_runs;
+    size_t          largest_free_run;
+    size_t          bump_remaining;
+    size_t          run_histogram[MALLOC_FRAG_BUCKETS];
+    double          external_fragmentation;
+} t_malloc_frag_report;
+
+typedef struct s_malloc_zone_residency {
+    uint64_t        start;
+    uint32_t        type;
+    uint32_t        chunks;
+    size_t          mapped;
+    size_t          resident;
+    size_t          free_bytes;
+    size_t          free_resident;
+    size_t          header_bytes;
+} t_malloc_zone_residency;
+
+typedef struct s_malloc_residency {
+    size_t          zones;
+    size_t          mapped;
+    size_t          resident;
+    size_t          free_bytes;
+    size_t          free_resident;
+    size_t          header_bytes;
+} t_malloc_residency;
+
+# define MALLOC_HOOKS_MAX 8
+
+typedef struct s_malloc_hooks {
+    void            (*on_malloc)(void *arg, void *ptr, size_t size);
+    void            (*on_free)(void *arg, void *ptr);
+    void            (*on_realloc)(void *arg, void *old_ptr, void *new_ptr, size_t size);
+    void            (*on_zone_create)(void *arg, void *start, size_t size, int type);
+    void            (*on_zone_destroy)(void *arg, void *start, size_t size, int type);
+    void            *arg;
+} t_malloc_hooks;
+
+int     malloc_hooks_register(const t_malloc_hooks *hooks);
+int     malloc_hooks_unregister(int id);
+
+typedef struct s_malloc_thread_stats {
+    uint64_t        thread_id;
+    uint32_t        alive;
+    uint32_t        index;
+    uint64_t        allocs;
+    uint64_t        frees;
+    uint64_t        remote_frees;
+    uint64_t        bytes_allocated;
+    uint64_t        bytes_in_flight;
+} t_malloc_thread_stats;
+
+int     get_malloc_thread_stats(t_malloc_thread_stats *threads, size_t max_threads);
+void    show_malloc_thread_stats(size_t top);
+
+typedef struct s_malloc_trim_report {
+    size_t          bytes_released;
+    size_t          zones_released[3];
+    size_t          bytes_unmapped[3];
+    size_t          bytes_purged[3];
+} t_malloc_trim_report;
+
+typedef struct s_malloc_pool t_malloc_pool;
+
 int     get_malloc_stats(t_malloc_stats *stats);
+int     get_malloc_size_classes(t_malloc_size_class *classes, size_t max_classes);
 int     check_malloc_leaks(void);
+int     malloc_prof_dump(int fd);
+int     malloc_leak_report(int fd);
+int     get_malloc_latency(t_malloc_latency *latency);
+void    malloc_latency_reset(void);
+void    show_malloc_latency(void);
+int     get_malloc_lock_stats(t_malloc_lock_stats *stats);
+void    malloc_lock_stats_reset(void);
+void    show_malloc_lock_stats(void);
+int     get_malloc_fragmentation(t_malloc_frag_report *report,
+                                 t_malloc_zone_frag *zones, size_t max_zones);
+void    show_malloc_fragmentation(void);
+int     get_malloc_residency(t_malloc_residency *report,
+                             t_malloc_zone_residency *zones, size_t max_zones);
+void    show_malloc_residency(void);
 int     malloc_cleanup(void);
 void    malloc_destroy(void);
+int     malloc_trim(size_t pad);
+size_t  malloc_trim_ex(size_t pad, t_malloc_trim_report *report);
+int     malloc_ctl(const char *name, void *oldp, size_t *oldlenp,
+                   const void *newp, size_t newlen);
+
+t_malloc_pool   *pool_create(size_t object_size, size_t alignment);
+void            *pool_alloc(t_malloc_pool *pool);
+void            pool_free(t_malloc_pool *pool, void *ptr);
+void            pool_destroy(t_malloc_pool *pool);
+void            pool_thread_flush(void);
 
 #endif
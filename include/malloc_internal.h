@@ -16,23 +16,71 @@
 # define MAX_ZONES_PER_TYPE 1000
 # define MAX_CHUNKS_PER_ZONE 10000
 # define MAX_ZONE_SEARCH 100
+# define MIN_ALLOCS_PER_ZONE 100
+
+# define MALLOC_CONF_ENV "MALLOC_CONF"
+# define MAX_CONF_LENGTH 4096
+# define MAX_CONF_KEY 64
 
 # define CHUNK_MAGIC_ALLOCATED 0xDEADBEEF
 # define CHUNK_MAGIC_FREE 0xFEEDFACE
 # define ZONE_MAGIC 0xCAFEBABE
 
+# define CHUNK_FLAG_PURGED 0x1
+# define CHUNK_FLAG_SAMPLED 0x2
+# define CHUNK_FLAG_TRACKED 0x4
+# define CHUNK_OWNER_SHIFT 16
+
+# define THREAD_STATS_MAX 1024
+
+# define MEMORY_NT_THRESHOLD (512 * 1024)
+
+# define PTR_TABLE_INITIAL 1024
+# define PROF_MAX_FRAMES 32
+# define PROF_MAX_PERIOD ((size_t)1 << 40)
+
+# define SIZE_CLASS_TINY_STEP 16
+# define SIZE_CLASS_SMALL_STEP 128
+# define SIZE_CLASS_TINY_COUNT (TINY_MAX / SIZE_CLASS_TINY_STEP)
+# define SIZE_CLASS_SMALL_COUNT ((SMALL_MAX - TINY_MAX) / SIZE_CLASS_SMALL_STEP)
+
+# define POOL_SLAB_SIZE (16 * 4096)
+# define POOL_MAX_OBJECT_SIZE (POOL_SLAB_SIZE / 8)
+# define POOL_MAX_ALIGNMENT 4096
+# define POOL_TCACHE_SLOTS 8
+# define POOL_TCACHE_MAX 64
+# define POOL_REFILL_BATCH 32
+# define MAX_POOLS 1000
+# define MAX_SLABS_PER_POOL 100000
+# define POOL_SLAB_TABLE_MIN 256
+
+# define POOL_MAGIC 0xBAADF00D
+# define SLAB_MAGIC 0xFACEFEED
+# define POOL_FREE_KEY 0x5EEDF4EEDEADB10CULL
+# define POOL_OBJECT_KEY(pool) ((uintptr_t)(pool) ^ POOL_FREE_KEY)
+
 typedef enum {
     ZONE_TINY = 0,
     ZONE_SMALL = 1,
     ZONE_LARGE = 2
 } t_zone_type;
 
+typedef enum {
+    VM_MMAP = 0,
+    VM_MUNMAP = 1,
+    VM_MADVISE = 2,
+    VM_MREMAP = 3,
+    VM_OP_COUNT = 4
+} t_vm_op;
+
 typedef struct s_zone t_zone;
 
 typedef struct s_chunk {
     uint32_t magic;
+    uint32_t slack;
     size_t size;
     int is_free;
+    uint32_t flags;
     struct s_chunk *next;
     struct s_chunk *prev;
     t_zone *zone;
@@ -50,9 +98,109 @@ typedef struct s_zone {
     size_t chunk_count;
 } t_zone;
 
+typedef struct s_pool_object {
+    struct s_pool_object *next;
+    uintptr_t key;
+} t_pool_object;
+
+typedef struct s_pool_slab {
+    uint32_t magic;
+    struct s_malloc_pool *pool;
+    struct s_pool_slab *next;
+    void *objects;
+} t_pool_slab;
+
+typedef struct s_pool_slab_table {
+    struct s_pool_slab_table *prev;
+    size_t map_size;
+    size_t mask;
+    uintptr_t slots[];
+} t_pool_slab_table;
+
+struct s_malloc_pool {
+    uint32_t magic;
+    uint32_t id;
+    size_t object_size;
+    size_t stride;
+    size_t alignment;
+    pthread_mutex_t lock;
+    t_pool_object *free_list;
+    char *bump;
+    char *bump_end;
+    t_pool_slab *slabs;
+    t_pool_slab_table *slab_table;
+    size_t slab_count;
+    size_t objects_in_use;
+    struct s_malloc_pool *next;
+};
+
+typedef struct {
+    uint32_t pool_id;
+    uint32_t count;
+    t_pool_object *head;
+    t_pool_slab *slab_hint;
+} t_pool_tcache;
+
 typedef struct {
+    size_t tiny_max;
+    size_t small_max;
+    size_t tiny_zone_size;
+    size_t small_zone_size;
+    size_t min_split_size;
+    size_t max_zone_search;
+    size_t pool_tcache_max;
+    size_t prof_sample;
+    size_t latency_enabled;
+    size_t leak_report;
+} t_malloc_config;
+
+typedef struct {
+    size_t bytes_allocated;
+    size_t bytes_peak;
+    size_t bytes_total;
+    size_t bytes_mapped;
+    uint32_t allocs[3];
+    uint32_t zones_active;
+    uint32_t zones_total;
+    uint32_t zones_by_type[3];
+    size_t reuse_hits;
+    size_t reuse_misses;
+    uint32_t errors_count;
+    uint32_t corruption_count;
+    uint32_t pools_active;
+    size_t pool_slabs;
+    size_t pool_objects_in_use;
+    size_t pool_bytes_mapped;
+    size_t hook_events_dropped;
+    size_t vm_calls[VM_OP_COUNT];
+    size_t vm_bytes[VM_OP_COUNT];
+    size_t class_count[MALLOC_SIZE_CLASSES];
+    size_t class_allocs[MALLOC_SIZE_CLASSES];
+    size_t class_frees[MALLOC_SIZE_CLASSES];
+    size_t class_bytes[MALLOC_SIZE_CLASSES];
+    size_t class_wasted[MALLOC_SIZE_CLASSES];
+} __attribute__((aligned(64))) t_stats_counters;
+
+# define STAT_LOAD(field) __atomic_load_n(&(field), __ATOMIC_RELAXED)
+# define STAT_ADD(field, value) \
+    __atomic_store_n(&(field), STAT_LOAD(field) + (value), __ATOMIC_RELAXED)
+# define STAT_SUB(field, value) \
+    __atomic_store_n(&(field), STAT_LOAD(field) - (value), __ATOMIC_RELAXED)
+# define STAT_ATOMIC_ADD(field, value) \
+    __atomic_fetch_add(&(field), (value), __ATOMIC_RELAXED)
+# define STAT_ATOMIC_SUB(field, value) \
+    __atomic_fetch_sub(&(field), (value), __ATOMIC_RELAXED)
+
+typedef struct {
+    t_malloc_config config;
+    int config_loaded;
     t_zone *zones[3];
     size_t zone_counts[3];
+    t_malloc_pool *pools;
+    uint32_t pool_count;
+    uint32_t pool_next_id;
+    uint32_t hook_count;
+    t_stats_counters stats;
 } t_zone_manager;
 
 # define CHUNK_HEADER_SIZE ALIGN(sizeof(t_chunk))
@@ -68,23 +216,158 @@ void add_zone_to_manager(t_zone *zone);
 void remove_zone_from_manager(t_zone *zone);
 t_zone *find_or_create_zone(t_zone_type type, size_t size);
 t_zone *find_zone_for_chunk(t_chunk *chunk);
+size_t zone_list_limit(int type);
 int is_zone_empty(t_zone *zone);
+void unmap_zone(t_zone *zone);
 
+t_chunk *allocate_chunk(size_t aligned_size);
+void *malloc_from(size_t size, void *site);
 t_chunk *create_chunk_in_zone(t_zone *zone, size_t size);
 t_chunk *find_free_chunk(t_zone *zone, size_t size);
 void split_chunk(t_chunk *chunk, size_t size, t_zone *zone);
 void merge_adjacent_chunks(t_chunk *chunk, t_zone *zone);
 void *get_user_ptr(t_chunk *chunk);
 t_chunk *get_chunk_from_ptr(void *ptr);
+t_chunk *zone_first_chunk(t_zone *zone);
+t_chunk *zone_next_chunk(t_zone *zone, t_chunk *chunk);
 
 int validate_chunk(t_chunk *chunk);
 int validate_zone(t_zone *zone);
 
-void print_zone_header(const char *zone_name, void *address);
-void print_allocation(void *start, void *end, size_t size);
-void print_total(size_t total);
+# define OUT_BUFFER_SIZE 16384
+
+typedef struct {
+    int fd;
+    size_t len;
+    char data[OUT_BUFFER_SIZE];
+} t_out_buffer;
+
+typedef struct {
+    char *slots;
+    size_t entry_size;
+    size_t capacity;
+    size_t count;
+} t_ptr_table;
+
+void *ptr_table_insert(t_ptr_table *table, void *key);
+void *ptr_table_find(const t_ptr_table *table, const void *key);
+int ptr_table_remove(t_ptr_table *table, const void *key);
+void *ptr_table_next(const t_ptr_table *table, size_t *cursor);
+void ptr_table_clear(t_ptr_table *table);
+
+void malloc_lock(t_malloc_lock_site site);
+void malloc_unlock(void);
+void lock_acquire(pthread_mutex_t *mutex, t_malloc_lock_site site);
+
+# define LATENCY_OFF 0
+# define LATENCY_NESTED 1
+
+uint64_t latency_begin(void);
+void latency_end(t_malloc_op op, int zone_type, uint64_t start);
+void latency_note_mmap(void);
+void latency_note_munmap(void);
+
+# define TRACE_OFF 0
+# define TRACE_NESTED 1
+# define TRACE_BUFFER_RECORDS 4096
+
+uint64_t trace_begin(void);
+void trace_end(uint64_t start, t_malloc_op op, void *ptr, void *old_ptr, size_t size);
+
+# define HOOK_OFF 0
+# define HOOK_NESTED 1
+# define HOOK_FIRE 2
+# define HOOK_ZONE_QUEUE 32
+# define HOOK_BEGIN() (__builtin_expect(STAT_LOAD(g_manager.hook_count) != 0, 0) ? \
+    hook_enter() : HOOK_OFF)
+# define HOOK_END(state, op, ptr, old_ptr, size) do { \
+    if (__builtin_expect((state) != HOOK_OFF, 0)) \
+        hook_end(state, op, ptr, old_ptr, size); \
+} while (0)
+
+int hook_enter(void);
+void hook_end(int state, t_malloc_op op, void *ptr, void *old_ptr, size_t size);
+void hook_note_zone(t_zone *zone, int created);
+void hook_flush(void);
+
+int prof_should_sample(size_t size);
+void prof_record(void *ptr, size_t size);
+void prof_forget_chunk(t_chunk *chunk);
+void prof_reset(void);
+int prof_frame_is_internal(void *pc);
+uintptr_t prof_sample_site(const void *ptr);
+
+# define LEAK_REPORT_MAX_SITES 50
+
+void leak_track(t_chunk *chunk, void *site);
+uintptr_t leak_chunk_site(t_chunk *chunk);
+void leak_forget_chunk(t_chunk *chunk);
+void leak_reset(void);
+
+void out_init(t_out_buffer *out, int fd);
+void out_flush(t_out_buffer *out);
+void out_char(t_out_buffer *out, char c);
+void out_str(t_out_buffer *out, const char *str);
+void out_hex(t_out_buffer *out, unsigned long n);
+void out_nbr(t_out_buffer *out, size_t n);
+void out_bytes(t_out_buffer *out, const void *data, size_t len);
+
+typedef struct s_heap_entry {
+    uint64_t start;
+    uint64_t size;
+    uint32_t type;
+    uint32_t kind;
+    uint32_t slack;
+    uint32_t flags;
+    uint64_t site;
+} t_heap_entry;
+
+typedef struct s_heap_snapshot {
+    t_heap_entry *records;
+    size_t count;
+    size_t capacity;
+} t_heap_snapshot;
+
+int heap_snapshot_take(t_heap_snapshot *snap);
+void heap_snapshot_release(t_heap_snapshot *snap);
+
+void config_init(void);
+int config_validate(const t_malloc_config *config);
+int config_lookup(const char *name, size_t *offset);
+int config_exchange(size_t offset, size_t *old_value, const size_t *new_value);
+
+t_malloc_pool *find_pool_by_id(uint32_t id);
+
+void stats_record_alloc(t_chunk *chunk);
+void stats_record_free(t_chunk *chunk);
+void stats_record_resize(t_chunk *chunk, size_t old_size, uint32_t old_slack);
+size_t size_class_index(size_t size);
+size_t size_class_max(size_t index);
+void stats_record_zone_map(t_zone *zone);
+void stats_record_zone_unmap(t_zone *zone);
+void stats_record_error(int corruption);
+void stats_record_vm(t_vm_op op, size_t bytes);
+void thread_stats_alloc(t_chunk *chunk);
+void thread_stats_free(t_chunk *chunk);
+void thread_stats_resize(t_chunk *chunk, size_t released);
+void thread_stats_reset_live(void);
+void thread_stats_attach(void);
+void stats_reset_live(void);
+uint64_t stats_timestamp(void);
+void stats_publish(void);
+
+void *vm_map(size_t size);
+void vm_unmap(void *ptr, size_t size);
+int vm_purge(void *ptr, size_t size);
+
+# define MEMORY_KERNEL_WORDS 0
+# define MEMORY_KERNEL_SSE2 1
+# define MEMORY_KERNEL_AVX2 2
 
 void *ft_memcpy(void *dst, const void *src, size_t n);
 void *ft_memset(void *b, int c, size_t len);
+int ft_strequal(const char *a, const char *b);
+int memory_kernel(void);
+int memory_use_kernel(size_t kernel);
 
 #endif
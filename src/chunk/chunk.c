@@ -16,6 +16,7 @@ t_chunk *create_chunk_in_zone(t_zone *zone, size_t size)
     chunk->magic = CHUNK_MAGIC_ALLOCATED;
     chunk->size = size;
     chunk->is_free = 0;
+    chunk->flags = 0;
     chunk->next = zone->chunks;
     chunk->prev = NULL;
     chunk->zone = zone;
@@ -47,7 +48,7 @@ t_chunk *find_free_chunk(t_zone *zone, size_t size)
 
 void split_chunk(t_chunk *chunk, size_t size, t_zone *zone)
 {
-    if (chunk->size < size + CHUNK_HEADER_SIZE + MIN_SPLIT_SIZE)
+    if (chunk->size < size + CHUNK_HEADER_SIZE + g_manager.config.min_split_size)
         return;
 
     if (zone && zone->chunk_count >= MAX_CHUNKS_PER_ZONE)
@@ -59,6 +60,7 @@ void split_chunk(t_chunk *chunk, size_t size, t_zone *zone)
     new_chunk->magic = CHUNK_MAGIC_FREE;
     new_chunk->size = chunk->size - size - CHUNK_HEADER_SIZE;
     new_chunk->is_free = 1;
+    new_chunk->flags = 0;
     new_chunk->next = chunk->next;
     new_chunk->prev = chunk;
     new_chunk->zone = zone;
@@ -93,6 +95,7 @@ void merge_adjacent_chunks(t_chunk *chunk, t_zone *zone)
         void *expected_addr = (char *)chunk->prev + CHUNK_HEADER_SIZE + chunk->prev->size;
         if (expected_addr == (void *)chunk) {
             chunk->prev->size += CHUNK_HEADER_SIZE + chunk->size;
+            chunk->prev->flags &= ~CHUNK_FLAG_PURGED;
             chunk->prev->next = chunk->next;
             if (chunk->next)
                 chunk->next->prev = chunk->prev;
@@ -114,6 +117,28 @@ t_chunk *get_chunk_from_ptr(void *ptr)
     return (t_chunk *)((char *)ptr - CHUNK_HEADER_SIZE);
 }
 
+t_chunk *zone_first_chunk(t_zone *zone)
+{
+    if (zone->type == ZONE_LARGE)
+        return zone->chunks;
+    if (zone->used_size <= ZONE_HEADER_SIZE)
+        return NULL;
+    return (t_chunk *)((char *)zone->start + ZONE_HEADER_SIZE);
+}
+
+t_chunk *zone_next_chunk(t_zone *zone, t_chunk *chunk)
+{
+    char *next = (char *)get_user_ptr(chunk) + chunk->size;
+
+    if (next >= (char *)zone->start + zone->used_size)
+        return NULL;
+
+    t_chunk *candidate = (t_chunk *)next;
+    if (candidate->magic != CHUNK_MAGIC_ALLOCATED && candidate->magic != CHUNK_MAGIC_FREE)
+        return NULL;
+    return candidate;
+}
+
 int validate_chunk(t_chunk *chunk)
 {
     if (!chunk)
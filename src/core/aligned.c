@@ -0,0 +1,115 @@
+#include "../../include/malloc_internal.h"
+#include <stdint.h>
+
+static t_chunk *split_chunk_head(t_chunk *chunk, size_t alignment, t_zone *zone)
+{
+    uintptr_t user = (uintptr_t)get_user_ptr(chunk);
+
+    if (user % alignment == 0)
+        return chunk;
+
+    if (zone->chunk_count >= MAX_CHUNKS_PER_ZONE)
+        return NULL;
+
+    uintptr_t aligned_user = (user + CHUNK_HEADER_SIZE + alignment - 1) &
+                             ~((uintptr_t)alignment - 1);
+    t_chunk *aligned = (t_chunk *)(aligned_user - CHUNK_HEADER_SIZE);
+    size_t head_size = (uintptr_t)aligned - user;
+
+    aligned->magic = CHUNK_MAGIC_ALLOCATED;
+    aligned->size = chunk->size - head_size - CHUNK_HEADER_SIZE;
+    aligned->is_free = 0;
+    aligned->flags = 0;
+    aligned->next = chunk->next;
+    aligned->prev = chunk;
+    aligned->zone = zone;
+
+    if (chunk->next)
+        chunk->next->prev = aligned;
+    chunk->next = aligned;
+    chunk->size = head_size;
+    chunk->magic = CHUNK_MAGIC_FREE;
+    chunk->is_free = 1;
+    zone->chunk_count++;
+
+    merge_adjacent_chunks(chunk, zone);
+    return aligned;
+}
+
+static t_chunk *allocate_aligned_in_class(size_t size, size_t alignment)
+{
+    t_chunk *chunk = allocate_chunk(size + alignment + CHUNK_HEADER_SIZE);
+    if (!chunk)
+        return NULL;
+
+    t_zone *zone = chunk->zone;
+    t_chunk *aligned = split_chunk_head(chunk, alignment, zone);
+    if (!aligned) {
+        chunk->magic = CHUNK_MAGIC_FREE;
+        chunk->is_free = 1;
+        merge_adjacent_chunks(chunk, zone);
+        return NULL;
+    }
+
+    split_chunk(aligned, size, zone);
+    return aligned;
+}
+
+static t_chunk *allocate_aligned_large(size_t size, size_t alignment)
+{
+    t_zone *zone = create_zone(ZONE_LARGE, size + alignment);
+    if (!zone)
+        return NULL;
+    add_zone_to_manager(zone);
+
+    uintptr_t first_user = (uintptr_t)zone->start + ZONE_HEADER_SIZE + CHUNK_HEADER_SIZE;
+    uintptr_t aligned_user = (first_user + alignment - 1) & ~((uintptr_t)alignment - 1);
+    zone->used_size = aligned_user - CHUNK_HEADER_SIZE - (uintptr_t)zone->start;
+
+    return create_chunk_in_zone(zone, size);
+}
+
+void *malloc_aligned(size_t alignment, size_t size)
+{
+    if (size == 0 || alignment == 0 || (alignment & (alignment - 1)) != 0)
+        return NULL;
+
+    if (alignment <= ALIGNMENT)
+        return malloc(size);
+
+    size_t aligned_size = ALIGN(size);
+    if (aligned_size < size || aligned_size + alignment + CHUNK_HEADER_SIZE < aligned_size)
+        return NULL;
+
+    int hook = HOOK_BEGIN();
+    uint64_t start = latency_begin();
+    uint64_t trace = trace_begin();
+    malloc_lock(MALLOC_LOCK_ALIGNED);
+    config_init();
+
+    t_chunk *chunk = NULL;
+    if (get_zone_type(aligned_size + alignment + CHUNK_HEADER_SIZE) != ZONE_LARGE)
+        chunk = allocate_aligned_in_class(aligned_size, alignment);
+    if (!chunk)
+        chunk = allocate_aligned_large(aligned_size, alignment);
+    int sampled = 0;
+    int type = chunk ? (int)chunk->zone->type : ZONE_LARGE;
+    if (chunk) {
+        chunk->slack = (uint32_t)(chunk->size - size);
+        stats_record_alloc(chunk);
+        sampled = prof_should_sample(size);
+        if (sampled)
+            chunk->flags |= CHUNK_FLAG_SAMPLED;
+        leak_track(chunk, __builtin_return_address(0));
+    }
+
+    malloc_unlock();
+
+    void *ptr = chunk ? get_user_ptr(chunk) : NULL;
+    if (sampled)
+        prof_record(ptr, size);
+    trace_end(trace, MALLOC_OP_MALLOC, ptr, NULL, size);
+    latency_end(MALLOC_OP_MALLOC, type, start);
+    HOOK_END(hook, MALLOC_OP_MALLOC, ptr, NULL, size);
+    return ptr;
+}
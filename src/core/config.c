@@ -0,0 +1,218 @@
+#include "../../include/malloc_internal.h"
+#include <stddef.h>
+#include <unistd.h>
+
+typedef struct {
+    const char *name;
+    size_t offset;
+} t_config_key;
+
+static const t_config_key g_config_keys[] = {
+    {"zone.tiny.max", offsetof(t_malloc_config, tiny_max)},
+    {"zone.small.max", offsetof(t_malloc_config, small_max)},
+    {"zone.tiny.size", offsetof(t_malloc_config, tiny_zone_size)},
+    {"zone.small.size", offsetof(t_malloc_config, small_zone_size)},
+    {"zone.search_limit", offsetof(t_malloc_config, max_zone_search)},
+    {"chunk.min_split", offsetof(t_malloc_config, min_split_size)},
+    {"pool.tcache.max", offsetof(t_malloc_config, pool_tcache_max)},
+    {"prof.sample", offsetof(t_malloc_config, prof_sample)},
+    {"latency.enabled", offsetof(t_malloc_config, latency_enabled)},
+    {"leak.report", offsetof(t_malloc_config, leak_report)},
+};
+
+#define CONFIG_KEY_COUNT (sizeof(g_config_keys) / sizeof(g_config_keys[0]))
+
+static size_t *config_field(t_malloc_config *config, size_t offset)
+{
+    return (size_t *)((char *)config + offset);
+}
+
+static int zone_fits_allocations(size_t zone_size, size_t max_alloc)
+{
+    size_t page_size = GET_PAGE_SIZE();
+
+    if (zone_size == 0 || zone_size % page_size != 0)
+        return 0;
+
+    return zone_size >= ZONE_HEADER_SIZE +
+        MIN_ALLOCS_PER_ZONE * (CHUNK_HEADER_SIZE + max_alloc);
+}
+
+int config_validate(const t_malloc_config *config)
+{
+    if (config->tiny_max < ALIGNMENT || config->tiny_max % ALIGNMENT != 0)
+        return 0;
+
+    if (config->small_max <= config->tiny_max || config->small_max % ALIGNMENT != 0)
+        return 0;
+
+    if (!zone_fits_allocations(config->tiny_zone_size, config->tiny_max))
+        return 0;
+
+    if (!zone_fits_allocations(config->small_zone_size, config->small_max))
+        return 0;
+
+    if (config->max_zone_search == 0 || config->max_zone_search > MAX_ZONES_PER_TYPE)
+        return 0;
+
+    if (config->min_split_size > config->small_max)
+        return 0;
+
+    if (config->pool_tcache_max < 2 || config->pool_tcache_max > MAX_CHUNKS_PER_ZONE)
+        return 0;
+
+    if (config->prof_sample > PROF_MAX_PERIOD)
+        return 0;
+
+    if (config->latency_enabled > 1 || config->leak_report > 1)
+        return 0;
+
+    return 1;
+}
+
+int config_lookup(const char *name, size_t *offset)
+{
+    for (size_t i = 0; i < CONFIG_KEY_COUNT; i++) {
+        if (ft_strequal(name, g_config_keys[i].name)) {
+            *offset = g_config_keys[i].offset;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int parse_size(const char *str, size_t len, size_t *value)
+{
+    size_t result = 0;
+    size_t i = 0;
+
+    if (len == 0)
+        return 0;
+
+    while (i < len && str[i] >= '0' && str[i] <= '9') {
+        if (result > ((size_t)-1 - 9) / 10)
+            return 0;
+        result = result * 10 + (size_t)(str[i] - '0');
+        i++;
+    }
+
+    if (i == 0)
+        return 0;
+
+    if (i + 1 == len) {
+        char unit = str[i];
+        int shift = (unit == 'k' || unit == 'K') ? 10 :
+                    (unit == 'm' || unit == 'M') ? 20 :
+                    (unit == 'g' || unit == 'G') ? 30 : -1;
+        if (shift < 0 || result > ((size_t)-1 >> shift))
+            return 0;
+        result <<= shift;
+    } else if (i != len) {
+        return 0;
+    }
+
+    *value = result;
+    return 1;
+}
+
+static void conf_warning(const char *msg, const char *pair, size_t len)
+{
+    size_t msg_len = 0;
+
+    while (msg[msg_len])
+        msg_len++;
+
+    write(2, MALLOC_CONF_ENV ": ", sizeof(MALLOC_CONF_ENV ": ") - 1);
+    write(2, msg, msg_len);
+    write(2, pair, len);
+    write(2, "\n", 1);
+}
+
+static void apply_conf_pair(t_malloc_config *config, const char *pair, size_t len)
+{
+    char key[MAX_CONF_KEY];
+    size_t key_len = 0;
+    size_t offset;
+    size_t value;
+
+    while (key_len < len && pair[key_len] != ':' && pair[key_len] != '=')
+        key_len++;
+
+    if (key_len == len || key_len >= MAX_CONF_KEY) {
+        conf_warning("malformed option: ", pair, len);
+        return;
+    }
+
+    for (size_t i = 0; i < key_len; i++)
+        key[i] = pair[i];
+    key[key_len] = '\0';
+
+    if (!config_lookup(key, &offset)) {
+        conf_warning("unknown option: ", pair, len);
+        return;
+    }
+
+    if (!parse_size(pair + key_len + 1, len - key_len - 1, &value)) {
+        conf_warning("invalid value: ", pair, len);
+        return;
+    }
+
+    *config_field(config, offset) = value;
+}
+
+void config_init(void)
+{
+    if (g_manager.config_loaded)
+        return;
+    g_manager.config_loaded = 1;
+
+    const char *conf = getenv(MALLOC_CONF_ENV);
+    if (!conf)
+        return;
+
+    t_malloc_config candidate = g_manager.config;
+    size_t start = 0;
+    size_t i = 0;
+
+    while (i < MAX_CONF_LENGTH) {
+        if (conf[i] == ',' || conf[i] == '\0') {
+            if (i > start)
+                apply_conf_pair(&candidate, conf + start, i - start);
+            if (conf[i] == '\0')
+                break;
+            start = i + 1;
+        }
+        i++;
+    }
+
+    if (!config_validate(&candidate)) {
+        conf_warning("inconsistent settings, using defaults: ", conf, i);
+        return;
+    }
+
+    g_manager.config = candidate;
+}
+
+int config_exchange(size_t offset, size_t *old_value, const size_t *new_value)
+{
+    malloc_lock(MALLOC_LOCK_CONFIG);
+    config_init();
+    *old_value = *config_field(&g_manager.config, offset);
+
+    if (!new_value) {
+        malloc_unlock();
+        return 0;
+    }
+
+    t_malloc_config candidate = g_manager.config;
+    *config_field(&candidate, offset) = *new_value;
+
+    if (!config_validate(&candidate)) {
+        malloc_unlock();
+        return -1;
+    }
+
+    g_manager.config = candidate;
+    malloc_unlock();
+    return 0;
+}
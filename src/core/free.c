@@ -4,62 +4,125 @@
 
 static int validate_free_ptr(void *ptr, t_chunk **out_chunk)
 {
-    if ((uintptr_t)ptr % ALIGNMENT != 0)
+    if ((uintptr_t)ptr % ALIGNMENT != 0) {
+        stats_record_error(0);
         return 0;
+    }
 
     t_chunk *chunk = get_chunk_from_ptr(ptr);
     if (!chunk)
         return 0;
 
-    if (chunk->magic != CHUNK_MAGIC_ALLOCATED)
-        return 0;
-
-    if (chunk->is_free)
-        return 0;
-
-    if (!chunk->zone)
+    if (chunk->magic != CHUNK_MAGIC_ALLOCATED || chunk->is_free) {
+        stats_record_error(0);
         return 0;
+    }
 
-    if (!validate_zone(chunk->zone))
+    if (!chunk->zone || !validate_zone(chunk->zone)) {
+        stats_record_error(1);
         return 0;
+    }
 
     if ((void *)chunk < chunk->zone->start ||
-        (void *)chunk >= chunk->zone->end)
+        (void *)chunk >= chunk->zone->end) {
+        stats_record_error(1);
         return 0;
+    }
 
     void *expected_user_ptr = (char *)chunk + CHUNK_HEADER_SIZE;
-    if (ptr != expected_user_ptr)
+    if (ptr != expected_user_ptr) {
+        stats_record_error(1);
         return 0;
+    }
 
     *out_chunk = chunk;
     return 1;
 }
 
+static void release_chunk(t_chunk *chunk)
+{
+    t_zone *zone = chunk->zone;
+
+    stats_record_free(chunk);
+    prof_forget_chunk(chunk);
+    leak_forget_chunk(chunk);
+    chunk->magic = CHUNK_MAGIC_FREE;
+    chunk->is_free = 1;
+
+    merge_adjacent_chunks(chunk, zone);
+
+    if (zone->type == ZONE_LARGE && is_zone_empty(zone)) {
+        remove_zone_from_manager(zone);
+        unmap_zone(zone);
+    }
+}
+
 void free(void *ptr)
 {
     t_chunk *chunk;
+    int type = ZONE_TINY;
+    void *freed = NULL;
 
     if (!ptr)
         return;
 
-    pthread_mutex_lock(&g_mutex);
+    int hook = HOOK_BEGIN();
+    uint64_t start = latency_begin();
+    uint64_t trace = trace_begin();
+    malloc_lock(MALLOC_LOCK_FREE);
 
-    if (!validate_free_ptr(ptr, &chunk)) {
-        pthread_mutex_unlock(&g_mutex);
-        return;
+    if (validate_free_ptr(ptr, &chunk)) {
+        type = chunk->zone->type;
+        release_chunk(chunk);
+        freed = ptr;
     }
 
+    malloc_unlock();
+    trace_end(trace, MALLOC_OP_FREE, NULL, ptr, 0);
+    latency_end(MALLOC_OP_FREE, type, start);
+    HOOK_END(hook, MALLOC_OP_FREE, NULL, freed, 0);
+}
+
+static void release_chunk_sized(t_chunk *chunk, size_t size)
+{
     t_zone *zone = chunk->zone;
 
-    chunk->magic = CHUNK_MAGIC_FREE;
-    chunk->is_free = 1;
+    if (ALIGN(size) > g_manager.config.small_max && zone->type == ZONE_LARGE &&
+        zone->chunks == chunk && !chunk->next && ALIGN(size) <= chunk->size) {
+        stats_record_free(chunk);
+        prof_forget_chunk(chunk);
+        leak_forget_chunk(chunk);
+        chunk->magic = CHUNK_MAGIC_FREE;
+        chunk->is_free = 1;
+        remove_zone_from_manager(zone);
+        unmap_zone(zone);
+    } else {
+        release_chunk(chunk);
+    }
+}
 
-    merge_adjacent_chunks(chunk, zone);
+void free_sized(void *ptr, size_t size)
+{
+    t_chunk *chunk;
+    int type = ZONE_TINY;
+    void *freed = NULL;
 
-    if (zone->type == ZONE_LARGE && is_zone_empty(zone)) {
-        remove_zone_from_manager(zone);
-        munmap(zone->start, zone->total_size);
+    if (!ptr)
+        return;
+
+    int hook = HOOK_BEGIN();
+    uint64_t start = latency_begin();
+    uint64_t trace = trace_begin();
+    malloc_lock(MALLOC_LOCK_FREE);
+
+    if (validate_free_ptr(ptr, &chunk)) {
+        type = chunk->zone->type;
+        release_chunk_sized(chunk, size);
+        freed = ptr;
     }
 
-    pthread_mutex_unlock(&g_mutex);
+    malloc_unlock();
+    trace_end(trace, MALLOC_OP_FREE, NULL, ptr, 0);
+    latency_end(MALLOC_OP_FREE, type, start);
+    HOOK_END(hook, MALLOC_OP_FREE, NULL, freed, 0);
 }
@@ -1,4 +1,17 @@
 #include "../../include/malloc_internal.h"
 
-t_zone_manager g_manager = {0};
+t_zone_manager g_manager = {
+    .config = {
+        .tiny_max = TINY_MAX,
+        .small_max = SMALL_MAX,
+        .tiny_zone_size = TINY_ZONE_SIZE,
+        .small_zone_size = SMALL_ZONE_SIZE,
+        .min_split_size = MIN_SPLIT_SIZE,
+        .max_zone_search = MAX_ZONE_SEARCH,
+        .pool_tcache_max = POOL_TCACHE_MAX,
+        .prof_sample = 0,
+        .latency_enabled = 0,
+        .leak_report = 0
+    }
+};
 pthread_mutex_t g_mutex = PTHREAD_MUTEX_INITIALIZER;
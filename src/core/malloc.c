@@ -1,35 +1,67 @@
 #include "../../include/malloc_internal.h"
 
-void *malloc(size_t size)
+t_chunk *allocate_chunk(size_t aligned_size)
 {
-    if (size == 0)
-        return NULL;
-
-    pthread_mutex_lock(&g_mutex);
-
-    size_t aligned_size = ALIGN(size);
     t_zone_type type = get_zone_type(aligned_size);
 
     t_zone *zone = find_or_create_zone(type, aligned_size);
-    if (!zone) {
-        pthread_mutex_unlock(&g_mutex);
+    if (!zone)
         return NULL;
-    }
 
     t_chunk *chunk = find_free_chunk(zone, aligned_size);
 
     if (chunk) {
         chunk->magic = CHUNK_MAGIC_ALLOCATED;
         chunk->is_free = 0;
+        chunk->flags = 0;
         split_chunk(chunk, aligned_size, zone);
+        STAT_ADD(g_manager.stats.reuse_hits, 1);
     } else {
         chunk = create_chunk_in_zone(zone, aligned_size);
-        if (!chunk) {
-            pthread_mutex_unlock(&g_mutex);
-            return NULL;
-        }
+        STAT_ADD(g_manager.stats.reuse_misses, 1);
     }
 
-    pthread_mutex_unlock(&g_mutex);
-    return get_user_ptr(chunk);
+    return chunk;
+}
+
+void *malloc_from(size_t size, void *site)
+{
+    malloc_lock(MALLOC_LOCK_MALLOC);
+    config_init();
+
+    t_chunk *chunk = allocate_chunk(ALIGN(size));
+    int sampled = 0;
+    if (chunk) {
+        chunk->slack = (uint32_t)(chunk->size - size);
+        stats_record_alloc(chunk);
+        sampled = prof_should_sample(size);
+        if (sampled)
+            chunk->flags |= CHUNK_FLAG_SAMPLED;
+        leak_track(chunk, site);
+    }
+
+    malloc_unlock();
+
+    if (!chunk)
+        return NULL;
+
+    void *ptr = get_user_ptr(chunk);
+    if (sampled)
+        prof_record(ptr, size);
+    return ptr;
+}
+
+void *malloc(size_t size)
+{
+    if (size == 0)
+        return NULL;
+
+    int hook = HOOK_BEGIN();
+    uint64_t start = latency_begin();
+    uint64_t trace = trace_begin();
+    void *ptr = malloc_from(size, __builtin_return_address(0));
+    trace_end(trace, MALLOC_OP_MALLOC, ptr, NULL, size);
+    latency_end(MALLOC_OP_MALLOC, get_zone_type(ALIGN(size)), start);
+    HOOK_END(hook, MALLOC_OP_MALLOC, ptr, NULL, size);
+    return ptr;
 }
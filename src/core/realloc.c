@@ -25,31 +25,29 @@ static int validate_realloc_ptr(void *ptr)
     return 1;
 }
 
-void *realloc(void *ptr, size_t size)
+static void *realloc_chunk(void *ptr, size_t size, void *site)
 {
-    if (!ptr)
-        return malloc(size);
-
-    if (size == 0) {
-        free(ptr);
+    if (!validate_realloc_ptr(ptr)) {
+        stats_record_error(0);
         return NULL;
     }
 
-    if (!validate_realloc_ptr(ptr))
-        return NULL;
-
     t_chunk *chunk = get_chunk_from_ptr(ptr);
     size_t aligned_size = ALIGN(size);
 
     if (chunk->size >= aligned_size) {
-        pthread_mutex_lock(&g_mutex);
+        malloc_lock(MALLOC_LOCK_REALLOC);
         t_zone *zone = chunk->zone;
+        size_t old_size = chunk->size;
+        uint32_t old_slack = chunk->slack;
         split_chunk(chunk, aligned_size, zone);
-        pthread_mutex_unlock(&g_mutex);
+        chunk->slack = (uint32_t)(chunk->size - size);
+        stats_record_resize(chunk, old_size, old_slack);
+        malloc_unlock();
         return ptr;
     }
 
-    void *new_ptr = malloc(size);
+    void *new_ptr = malloc_from(size, site);
     if (!new_ptr)
         return NULL;
 
@@ -59,3 +57,25 @@ void *realloc(void *ptr, size_t size)
 
     return new_ptr;
 }
+
+void *realloc(void *ptr, size_t size)
+{
+    if (!ptr && size == 0)
+        return NULL;
+
+    if (ptr && size == 0) {
+        free(ptr);
+        return NULL;
+    }
+
+    t_malloc_op op = ptr ? MALLOC_OP_REALLOC : MALLOC_OP_MALLOC;
+    void *site = __builtin_return_address(0);
+    int hook = HOOK_BEGIN();
+    uint64_t start = latency_begin();
+    uint64_t trace = trace_begin();
+    void *new_ptr = ptr ? realloc_chunk(ptr, size, site) : malloc_from(size, site);
+    trace_end(trace, op, new_ptr, ptr, size);
+    latency_end(op, get_zone_type(ALIGN(size)), start);
+    HOOK_END(hook, op, new_ptr, ptr, size);
+    return new_ptr;
+}
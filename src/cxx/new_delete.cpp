@@ -0,0 +1,152 @@
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+extern "C" {
+void *malloc_aligned(std::size_t alignment, std::size_t size);
+void free_sized(void *ptr, std::size_t size);
+}
+
+namespace {
+
+void *allocate(std::size_t size, std::size_t alignment)
+{
+    if (size == 0)
+        size = 1;
+
+    for (;;) {
+        void *ptr = (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+            ? malloc_aligned(alignment, size)
+            : std::malloc(size);
+        if (ptr)
+            return ptr;
+
+        std::new_handler handler = std::get_new_handler();
+        if (!handler)
+            throw std::bad_alloc();
+        handler();
+    }
+}
+
+void *allocate_nothrow(std::size_t size, std::size_t alignment) noexcept
+{
+    try {
+        return allocate(size, alignment);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void release(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void release_sized(void *ptr, std::size_t size) noexcept
+{
+    free_sized(ptr, size == 0 ? 1 : size);
+}
+
+}
+
+void *operator new(std::size_t size)
+{
+    return allocate(size, 0);
+}
+
+void *operator new[](std::size_t size)
+{
+    return allocate(size, 0);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    return allocate_nothrow(size, 0);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+    return allocate_nothrow(size, 0);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment,
+                   const std::nothrow_t &) noexcept
+{
+    return allocate_nothrow(size, static_cast<std::size_t>(alignment));
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment,
+                     const std::nothrow_t &) noexcept
+{
+    return allocate_nothrow(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void *ptr) noexcept
+{
+    release(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    release(ptr);
+}
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept
+{
+    release(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept
+{
+    release(ptr);
+}
+
+void operator delete(void *ptr, std::size_t size) noexcept
+{
+    release_sized(ptr, size);
+}
+
+void operator delete[](void *ptr, std::size_t size) noexcept
+{
+    release_sized(ptr, size);
+}
+
+void operator delete(void *ptr, std::align_val_t) noexcept
+{
+    release(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t) noexcept
+{
+    release(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t, const std::nothrow_t &) noexcept
+{
+    release(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t, const std::nothrow_t &) noexcept
+{
+    release(ptr);
+}
+
+void operator delete(void *ptr, std::size_t size, std::align_val_t) noexcept
+{
+    release_sized(ptr, size);
+}
+
+void operator delete[](void *ptr, std::size_t size, std::align_val_t) noexcept
+{
+    release_sized(ptr, size);
+}
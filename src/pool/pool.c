@@ -0,0 +1,414 @@
+#define _GNU_SOURCE
+#include "../../include/malloc_internal.h"
+#include <stdint.h>
+
+static __thread t_pool_tcache g_pool_tcache[POOL_TCACHE_SLOTS];
+static __thread int g_pool_tcache_registered = 0;
+static pthread_key_t g_pool_tcache_key;
+static pthread_once_t g_pool_tcache_once = PTHREAD_ONCE_INIT;
+
+static void *map_slab_aligned(void)
+{
+    char *raw = vm_map(2 * POOL_SLAB_SIZE);
+    if (!raw)
+        return NULL;
+
+    uintptr_t addr = (uintptr_t)raw;
+    uintptr_t aligned = (addr + POOL_SLAB_SIZE - 1) & ~((uintptr_t)POOL_SLAB_SIZE - 1);
+    size_t head = aligned - addr;
+    size_t tail = POOL_SLAB_SIZE - head;
+
+    if (head)
+        vm_unmap(raw, head);
+    if (tail)
+        vm_unmap((char *)aligned + POOL_SLAB_SIZE, tail);
+
+    return (void *)aligned;
+}
+
+static size_t slab_table_index(const t_pool_slab_table *table, uintptr_t addr)
+{
+    return (size_t)(((addr / POOL_SLAB_SIZE) * 0x9E3779B97F4A7C15ULL) >> 32) & table->mask;
+}
+
+static void slab_table_insert(t_pool_slab_table *table, uintptr_t addr)
+{
+    size_t index = slab_table_index(table, addr);
+
+    while (table->slots[index])
+        index = (index + 1) & table->mask;
+    __atomic_store_n(&table->slots[index], addr, __ATOMIC_RELEASE);
+}
+
+static int slab_table_reserve(t_malloc_pool *pool)
+{
+    t_pool_slab_table *old = pool->slab_table;
+
+    if (old && (pool->slab_count + 1) * 2 <= old->mask + 1)
+        return 1;
+
+    size_t capacity = old ? (old->mask + 1) * 2 : POOL_SLAB_TABLE_MIN;
+    size_t map_size = sizeof(t_pool_slab_table) + capacity * sizeof(uintptr_t);
+    t_pool_slab_table *table = vm_map(map_size);
+    if (!table)
+        return 0;
+
+    table->prev = old;
+    table->map_size = map_size;
+    table->mask = capacity - 1;
+    for (size_t i = 0; old && i <= old->mask; i++) {
+        if (old->slots[i])
+            slab_table_insert(table, old->slots[i]);
+    }
+    __atomic_store_n(&pool->slab_table, table, __ATOMIC_RELEASE);
+    return 1;
+}
+
+static void slab_table_release(t_malloc_pool *pool)
+{
+    t_pool_slab_table *table = pool->slab_table;
+    int iterations = 0;
+
+    while (table && iterations < 64) {
+        t_pool_slab_table *prev = table->prev;
+        vm_unmap(table, table->map_size);
+        table = prev;
+        iterations++;
+    }
+    pool->slab_table = NULL;
+}
+
+static int pool_add_slab(t_malloc_pool *pool)
+{
+    if (pool->slab_count >= MAX_SLABS_PER_POOL || !slab_table_reserve(pool))
+        return 0;
+
+    t_pool_slab *slab = map_slab_aligned();
+    if (!slab)
+        return 0;
+
+    uintptr_t first = (uintptr_t)slab + sizeof(t_pool_slab);
+    first = (first + pool->alignment - 1) & ~((uintptr_t)pool->alignment - 1);
+
+    slab->magic = SLAB_MAGIC;
+    slab->pool = pool;
+    slab->next = pool->slabs;
+    slab->objects = (void *)first;
+
+    __atomic_store_n(&pool->slabs, slab, __ATOMIC_RELEASE);
+    slab_table_insert(pool->slab_table, (uintptr_t)slab);
+    pool->slab_count++;
+    STAT_ATOMIC_ADD(g_manager.stats.pool_slabs, 1);
+    STAT_ATOMIC_ADD(g_manager.stats.pool_bytes_mapped, POOL_SLAB_SIZE);
+    pool->bump = (char *)first;
+    pool->bump_end = (char *)slab + POOL_SLAB_SIZE;
+    return 1;
+}
+
+static void *pool_take_central(t_malloc_pool *pool)
+{
+    t_pool_object *obj = pool->free_list;
+
+    if (obj) {
+        pool->free_list = obj->next;
+        return obj;
+    }
+
+    if (pool->bump + pool->stride > pool->bump_end) {
+        if (!pool_add_slab(pool))
+            return NULL;
+    }
+
+    obj = (t_pool_object *)pool->bump;
+    pool->bump += pool->stride;
+    return obj;
+}
+
+static int pool_refill(t_malloc_pool *pool, t_pool_tcache *cache)
+{
+    int moved = 0;
+
+    lock_acquire(&pool->lock, MALLOC_LOCK_POOL);
+    while (moved < POOL_REFILL_BATCH) {
+        t_pool_object *obj = pool_take_central(pool);
+        if (!obj)
+            break;
+        obj->next = cache->head;
+        cache->head = obj;
+        moved++;
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    cache->count += moved;
+    return moved > 0;
+}
+
+static void pool_flush(t_malloc_pool *pool, t_pool_tcache *cache, uint32_t keep)
+{
+    lock_acquire(&pool->lock, MALLOC_LOCK_POOL);
+    while (cache->count > keep && cache->head) {
+        t_pool_object *obj = cache->head;
+        cache->head = obj->next;
+        obj->next = pool->free_list;
+        pool->free_list = obj;
+        cache->count--;
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+static void pool_release_cache(t_pool_tcache *cache)
+{
+    if (cache->count == 0) {
+        cache->head = NULL;
+        return;
+    }
+
+    malloc_lock(MALLOC_LOCK_POOL_ZONE);
+    t_malloc_pool *owner = find_pool_by_id(cache->pool_id);
+    if (owner)
+        pool_flush(owner, cache, 0);
+    malloc_unlock();
+
+    cache->head = NULL;
+    cache->count = 0;
+}
+
+static void pool_tcache_destructor(void *value)
+{
+    (void)value;
+    pool_thread_flush();
+}
+
+static void pool_tcache_key_init(void)
+{
+    pthread_key_create(&g_pool_tcache_key, pool_tcache_destructor);
+}
+
+static t_pool_tcache *pool_tcache_for(t_malloc_pool *pool)
+{
+    t_pool_tcache *cache = &g_pool_tcache[pool->id % POOL_TCACHE_SLOTS];
+
+    if (cache->pool_id == pool->id)
+        return cache;
+
+    if (!g_pool_tcache_registered) {
+        pthread_once(&g_pool_tcache_once, pool_tcache_key_init);
+        pthread_setspecific(g_pool_tcache_key, g_pool_tcache);
+        g_pool_tcache_registered = 1;
+    }
+
+    pool_release_cache(cache);
+    cache->pool_id = pool->id;
+    cache->slab_hint = NULL;
+    return cache;
+}
+
+static int validate_pool(t_malloc_pool *pool)
+{
+    return pool && pool->magic == POOL_MAGIC;
+}
+
+static int pool_owns_slab(t_malloc_pool *pool, t_pool_slab *slab)
+{
+    t_pool_slab_table *table = __atomic_load_n(&pool->slab_table, __ATOMIC_ACQUIRE);
+    uintptr_t addr = (uintptr_t)slab;
+
+    if (!table)
+        return 0;
+
+    size_t index = slab_table_index(table, addr);
+    for (size_t probes = 0; probes <= table->mask; probes++) {
+        uintptr_t entry = __atomic_load_n(&table->slots[index], __ATOMIC_ACQUIRE);
+        if (entry == addr)
+            return 1;
+        if (!entry)
+            return 0;
+        index = (index + 1) & table->mask;
+    }
+    return 0;
+}
+
+static int validate_pool_ptr(t_malloc_pool *pool, t_pool_tcache *cache, void *ptr)
+{
+    uintptr_t addr = (uintptr_t)ptr;
+    t_pool_slab *slab = (t_pool_slab *)(addr & ~((uintptr_t)POOL_SLAB_SIZE - 1));
+
+    if ((void *)slab == ptr)
+        return 0;
+
+    if (slab != cache->slab_hint && !pool_owns_slab(pool, slab))
+        return 0;
+    cache->slab_hint = slab;
+
+    if (slab->magic != SLAB_MAGIC || slab->pool != pool)
+        return 0;
+
+    if (addr < (uintptr_t)slab->objects || addr + pool->stride > (uintptr_t)slab + POOL_SLAB_SIZE)
+        return 0;
+
+    if ((addr - (uintptr_t)slab->objects) % pool->stride != 0)
+        return 0;
+
+    return 1;
+}
+
+t_malloc_pool *find_pool_by_id(uint32_t id)
+{
+    t_malloc_pool *pool = g_manager.pools;
+    int iterations = 0;
+
+    while (pool && iterations < MAX_POOLS) {
+        if (pool->id == id)
+            return pool;
+        pool = pool->next;
+        iterations++;
+    }
+    return NULL;
+}
+
+t_malloc_pool *pool_create(size_t object_size, size_t alignment)
+{
+    if (object_size == 0 || object_size > POOL_MAX_OBJECT_SIZE)
+        return NULL;
+
+    if (alignment < ALIGNMENT)
+        alignment = ALIGNMENT;
+    if ((alignment & (alignment - 1)) != 0 || alignment > POOL_MAX_ALIGNMENT)
+        return NULL;
+
+    malloc_lock(MALLOC_LOCK_POOL_ZONE);
+    config_init();
+    if (g_manager.pool_count >= MAX_POOLS) {
+        malloc_unlock();
+        return NULL;
+    }
+
+    t_malloc_pool *pool = vm_map(GET_PAGE_SIZE());
+    if (!pool) {
+        malloc_unlock();
+        return NULL;
+    }
+
+    pool->magic = POOL_MAGIC;
+    pool->id = ++g_manager.pool_next_id;
+    pool->object_size = object_size;
+    pool->alignment = alignment;
+    pool->stride = (object_size + alignment - 1) & ~(alignment - 1);
+    pthread_mutex_init(&pool->lock, NULL);
+
+    pool->next = g_manager.pools;
+    g_manager.pools = pool;
+    g_manager.pool_count++;
+    STAT_ADD(g_manager.stats.pools_active, 1);
+
+    malloc_unlock();
+    return pool;
+}
+
+void *pool_alloc(t_malloc_pool *pool)
+{
+    if (!validate_pool(pool))
+        return NULL;
+
+    t_pool_tcache *cache = pool_tcache_for(pool);
+    if (!cache->head && !pool_refill(pool, cache))
+        return NULL;
+
+    t_pool_object *obj = cache->head;
+    cache->head = obj->next;
+    cache->count--;
+    obj->key = 0;
+    STAT_ATOMIC_ADD(pool->objects_in_use, 1);
+    STAT_ATOMIC_ADD(g_manager.stats.pool_objects_in_use, 1);
+    return obj;
+}
+
+void pool_free(t_malloc_pool *pool, void *ptr)
+{
+    if (!ptr || !validate_pool(pool))
+        return;
+
+    t_pool_tcache *cache = pool_tcache_for(pool);
+    if (!validate_pool_ptr(pool, cache, ptr))
+        return;
+
+    t_pool_object *obj = (t_pool_object *)ptr;
+    if (obj->key == POOL_OBJECT_KEY(pool)) {
+        stats_record_error(0);
+        return;
+    }
+
+    obj->key = POOL_OBJECT_KEY(pool);
+    STAT_ATOMIC_SUB(pool->objects_in_use, 1);
+    STAT_ATOMIC_SUB(g_manager.stats.pool_objects_in_use, 1);
+    obj->next = cache->head;
+    cache->head = obj;
+    cache->count++;
+
+    size_t limit = __atomic_load_n(&g_manager.config.pool_tcache_max, __ATOMIC_RELAXED);
+    if (cache->count > limit)
+        pool_flush(pool, cache, (uint32_t)(limit / 2));
+}
+
+static void unlink_pool(t_malloc_pool *pool)
+{
+    t_malloc_pool *current = g_manager.pools;
+    t_malloc_pool *prev = NULL;
+    int iterations = 0;
+
+    while (current && iterations < MAX_POOLS) {
+        if (current == pool) {
+            if (prev)
+                prev->next = pool->next;
+            else
+                g_manager.pools = pool->next;
+            g_manager.pool_count--;
+            STAT_SUB(g_manager.stats.pools_active, 1);
+            return;
+        }
+        prev = current;
+        current = current->next;
+        iterations++;
+    }
+}
+
+void pool_destroy(t_malloc_pool *pool)
+{
+    if (!validate_pool(pool))
+        return;
+
+    malloc_lock(MALLOC_LOCK_POOL_ZONE);
+    unlink_pool(pool);
+    malloc_unlock();
+
+    t_pool_tcache *cache = &g_pool_tcache[pool->id % POOL_TCACHE_SLOTS];
+    if (cache->pool_id == pool->id) {
+        cache->head = NULL;
+        cache->count = 0;
+        cache->slab_hint = NULL;
+    }
+
+    t_pool_slab *slab = pool->slabs;
+    size_t iterations = 0;
+    while (slab && iterations < MAX_SLABS_PER_POOL) {
+        t_pool_slab *next = slab->next;
+        slab->magic = 0;
+        vm_unmap(slab, POOL_SLAB_SIZE);
+        slab = next;
+        iterations++;
+    }
+
+    STAT_ATOMIC_SUB(g_manager.stats.pool_slabs, pool->slab_count);
+    STAT_ATOMIC_SUB(g_manager.stats.pool_bytes_mapped, pool->slab_count * POOL_SLAB_SIZE);
+    STAT_ATOMIC_SUB(g_manager.stats.pool_objects_in_use, STAT_LOAD(pool->objects_in_use));
+    slab_table_release(pool);
+    pool->magic = 0;
+    pthread_mutex_destroy(&pool->lock);
+    vm_unmap(pool, GET_PAGE_SIZE());
+}
+
+void pool_thread_flush(void)
+{
+    for (int slot = 0; slot < POOL_TCACHE_SLOTS; slot++)
+        pool_release_cache(&g_pool_tcache[slot]);
+}
@@ -1,14 +1,13 @@
 #include "../../include/malloc_internal.h"
-#include <sys/mman.h>
 
 static int cleanup_empty_zones_of_type(t_zone_type type)
 {
 	t_zone *zone = g_manager.zones[type];
 	t_zone *prev = NULL;
 	int freed_count = 0;
-	int zone_iter = 0;
+	size_t zone_iter = 0;
 
-	while (zone && zone_iter < MAX_ZONES_PER_TYPE) {
+	while (zone && zone_iter < zone_list_limit(type)) {
 		t_zone *next_zone = zone->next;
 
 		if (is_zone_empty(zone)) {
@@ -17,7 +16,7 @@ static int cleanup_empty_zones_of_type(t_zone_type type)
 			else
 				g_manager.zones[type] = next_zone;
 
-			munmap(zone->start, zone->total_size);
+			unmap_zone(zone);
 
 			if (type != ZONE_LARGE && g_manager.zone_counts[type] > 0)
 				g_manager.zone_counts[type]--;
@@ -38,12 +37,13 @@ int malloc_cleanup(void)
 {
 	int total_freed = 0;
 
-	pthread_mutex_lock(&g_mutex);
+	malloc_lock(MALLOC_LOCK_MAINTENANCE);
 
 	for (int type = 0; type < 3; type++)
 		total_freed += cleanup_empty_zones_of_type(type);
 
-	pthread_mutex_unlock(&g_mutex);
+	malloc_unlock();
+	hook_flush();
 
 	return total_freed;
 }
@@ -59,13 +59,16 @@ static void secure_zero_zone(t_zone *zone)
 static void destroy_all_zones_of_type(t_zone_type type)
 {
 	t_zone *zone = g_manager.zones[type];
-	int zone_iter = 0;
+	size_t zone_iter = 0;
 
-	while (zone && zone_iter < MAX_ZONES_PER_TYPE) {
+	while (zone && zone_iter < zone_list_limit(type)) {
 		t_zone *next_zone = zone->next;
+		void *start = zone->start;
+		size_t size = zone->total_size;
 
+		stats_record_zone_unmap(zone);
 		secure_zero_zone(zone);
-		munmap(zone->start, zone->total_size);
+		vm_unmap(start, size);
 
 		zone = next_zone;
 		zone_iter++;
@@ -78,10 +81,14 @@ static void destroy_all_zones_of_type(t_zone_type type)
 
 void malloc_destroy(void)
 {
-	pthread_mutex_lock(&g_mutex);
+	malloc_lock(MALLOC_LOCK_MAINTENANCE);
 
 	for (int type = 0; type < 3; type++)
 		destroy_all_zones_of_type(type);
+	stats_reset_live();
+	prof_reset();
+	leak_reset();
 
-	pthread_mutex_unlock(&g_mutex);
+	malloc_unlock();
+	hook_flush();
 }
@@ -0,0 +1,197 @@
+#include "../../include/malloc_internal.h"
+
+typedef enum {
+    CTL_STAT,
+    CTL_ZONE,
+    CTL_LOCK,
+    CTL_KERNEL,
+    CTL_ACTION
+} t_ctl_kind;
+
+typedef enum {
+    ZONE_METRIC_COUNT,
+    ZONE_METRIC_MAPPED,
+    ZONE_METRIC_USED,
+    ZONE_METRIC_CHUNKS
+} t_zone_metric;
+
+typedef struct {
+    const char *name;
+    t_ctl_kind kind;
+    int arg;
+    int type;
+} t_ctl_entry;
+
+static const t_ctl_entry g_ctl_entries[] = {
+    {"stats.allocated", CTL_STAT, 0, 0},
+    {"stats.allocs.tiny", CTL_STAT, 1, 0},
+    {"stats.allocs.small", CTL_STAT, 2, 0},
+    {"stats.allocs.large", CTL_STAT, 3, 0},
+    {"stats.pools.active", CTL_STAT, 4, 0},
+    {"stats.pools.slabs", CTL_STAT, 5, 0},
+    {"stats.pools.in_use", CTL_STAT, 6, 0},
+    {"stats.pools.mapped", CTL_STAT, 7, 0},
+    {"stats.lock.acquired", CTL_LOCK, 0, 0},
+    {"stats.lock.contended", CTL_LOCK, 1, 0},
+    {"stats.lock.wait_ns", CTL_LOCK, 2, 0},
+    {"zone.tiny.count", CTL_ZONE, ZONE_METRIC_COUNT, ZONE_TINY},
+    {"zone.tiny.mapped", CTL_ZONE, ZONE_METRIC_MAPPED, ZONE_TINY},
+    {"zone.tiny.used", CTL_ZONE, ZONE_METRIC_USED, ZONE_TINY},
+    {"zone.tiny.chunks", CTL_ZONE, ZONE_METRIC_CHUNKS, ZONE_TINY},
+    {"zone.small.count", CTL_ZONE, ZONE_METRIC_COUNT, ZONE_SMALL},
+    {"zone.small.mapped", CTL_ZONE, ZONE_METRIC_MAPPED, ZONE_SMALL},
+    {"zone.small.used", CTL_ZONE, ZONE_METRIC_USED, ZONE_SMALL},
+    {"zone.small.chunks", CTL_ZONE, ZONE_METRIC_CHUNKS, ZONE_SMALL},
+    {"zone.large.count", CTL_ZONE, ZONE_METRIC_COUNT, ZONE_LARGE},
+    {"zone.large.mapped", CTL_ZONE, ZONE_METRIC_MAPPED, ZONE_LARGE},
+    {"zone.large.used", CTL_ZONE, ZONE_METRIC_USED, ZONE_LARGE},
+    {"zone.large.chunks", CTL_ZONE, ZONE_METRIC_CHUNKS, ZONE_LARGE},
+    {"memory.kernel", CTL_KERNEL, 0, 0},
+    {"arena.purge", CTL_ACTION, 0, 0},
+    {"thread.tcache.flush", CTL_ACTION, 1, 0},
+};
+
+#define CTL_ENTRY_COUNT (sizeof(g_ctl_entries) / sizeof(g_ctl_entries[0]))
+
+static const t_ctl_entry *find_entry(const char *name)
+{
+    for (size_t i = 0; i < CTL_ENTRY_COUNT; i++) {
+        if (ft_strequal(name, g_ctl_entries[i].name))
+            return &g_ctl_entries[i];
+    }
+    return NULL;
+}
+
+static int read_stat(int arg, size_t *value)
+{
+    t_malloc_stats stats;
+
+    if (get_malloc_stats(&stats) != 0)
+        return -1;
+
+    size_t fields[] = {
+        stats.bytes_allocated, stats.allocs_tiny, stats.allocs_small,
+        stats.allocs_large, stats.pools_active, stats.pool_slabs,
+        stats.pool_objects_in_use, stats.pool_bytes_mapped
+    };
+
+    *value = fields[arg];
+    return 0;
+}
+
+static int read_lock_stat(int arg, size_t *value)
+{
+    t_malloc_lock_stats stats;
+
+    if (get_malloc_lock_stats(&stats) != 0)
+        return -1;
+
+    size_t fields[] = {stats.acquisitions, stats.contended, stats.wait_ns};
+
+    *value = fields[arg];
+    return 0;
+}
+
+static int read_zone_metric(int type, int metric, size_t *value)
+{
+    size_t total = 0;
+
+    malloc_lock(MALLOC_LOCK_MAINTENANCE);
+
+    t_zone *zone = g_manager.zones[type];
+    size_t zone_iter = 0;
+    while (zone && zone_iter < zone_list_limit(type)) {
+        if (metric == ZONE_METRIC_COUNT)
+            total++;
+        else if (metric == ZONE_METRIC_MAPPED)
+            total += zone->total_size;
+        else if (metric == ZONE_METRIC_USED)
+            total += zone->used_size;
+        else
+            total += zone->chunk_count;
+        zone = zone->next;
+        zone_iter++;
+    }
+
+    malloc_unlock();
+
+    *value = total;
+    return 0;
+}
+
+static int run_action(int arg, size_t *value)
+{
+    if (arg == 0) {
+        *value = malloc_trim_ex(0, NULL);
+        return 0;
+    }
+
+    pool_thread_flush();
+    *value = 0;
+    return 0;
+}
+
+static int read_entry(const t_ctl_entry *entry, size_t *value)
+{
+    if (entry->kind == CTL_STAT)
+        return read_stat(entry->arg, value);
+    if (entry->kind == CTL_ZONE)
+        return read_zone_metric(entry->type, entry->arg, value);
+    if (entry->kind == CTL_LOCK)
+        return read_lock_stat(entry->arg, value);
+    if (entry->kind == CTL_KERNEL) {
+        *value = (size_t)memory_kernel();
+        return 0;
+    }
+    return run_action(entry->arg, value);
+}
+
+static int store_old(void *oldp, size_t *oldlenp, size_t value)
+{
+    if (!oldp)
+        return 0;
+
+    if (!oldlenp || *oldlenp < sizeof(size_t))
+        return -1;
+
+    *(size_t *)oldp = value;
+    *oldlenp = sizeof(size_t);
+    return 0;
+}
+
+int malloc_ctl(const char *name, void *oldp, size_t *oldlenp,
+               const void *newp, size_t newlen)
+{
+    size_t offset;
+    size_t value = 0;
+
+    if (!name)
+        return -1;
+
+    if (newp && newlen != sizeof(size_t))
+        return -1;
+
+    if (config_lookup(name, &offset)) {
+        if (oldp && (!oldlenp || *oldlenp < sizeof(size_t)))
+            return -1;
+        int result = config_exchange(offset, &value, newp);
+        store_old(oldp, oldlenp, value);
+        return result;
+    }
+
+    const t_ctl_entry *entry = find_entry(name);
+    if (!entry)
+        return -1;
+
+    if (newp && entry->kind != CTL_ACTION && entry->kind != CTL_KERNEL)
+        return -1;
+
+    if (read_entry(entry, &value) != 0)
+        return -1;
+
+    if (store_old(oldp, oldlenp, value) != 0)
+        return -1;
+    if (newp && entry->kind == CTL_KERNEL)
+        return memory_use_kernel(*(const size_t *)newp);
+    return 0;
+}
@@ -0,0 +1,189 @@
+#include "../../include/malloc_internal.h"
+#include <stdint.h>
+
+static const char *g_frag_zone_names[3] = {"TINY", "SMALL", "LARGE"};
+
+static int frag_bucket(size_t size)
+{
+    int bucket = size ? 63 - __builtin_clzll(size) - 4 : 0;
+
+    if (bucket < 0)
+        return 0;
+    if (bucket >= MALLOC_FRAG_BUCKETS)
+        return MALLOC_FRAG_BUCKETS - 1;
+    return bucket;
+}
+
+static double frag_ratio(size_t usable, size_t free_total)
+{
+    if (free_total == 0)
+        return 0.0;
+    return 1.0 - (double)usable / (double)free_total;
+}
+
+static size_t usable_bytes(const t_malloc_zone_frag *frag)
+{
+    if (frag->largest_free_run > frag->bump_remaining)
+        return frag->largest_free_run;
+    return frag->bump_remaining;
+}
+
+static void close_run(t_malloc_zone_frag *frag, t_malloc_frag_report *report, size_t run)
+{
+    if (run == 0)
+        return;
+
+    frag->free_runs++;
+    if (run > frag->largest_free_run)
+        frag->largest_free_run = run;
+    report->run_histogram[frag_bucket(run)]++;
+}
+
+static void measure_zone(t_zone *zone, t_malloc_zone_frag *frag, t_malloc_frag_report *report)
+{
+    t_chunk *chunk = zone_first_chunk(zone);
+    size_t run = 0;
+    size_t iterations = 0;
+
+    ft_memset(frag, 0, sizeof(*frag));
+    frag->start = (uint64_t)(uintptr_t)zone->start;
+    frag->type = zone->type;
+    frag->total_size = zone->total_size;
+    frag->used_size = zone->used_size;
+    if (zone->type != ZONE_LARGE && zone->total_size > zone->used_size)
+        frag->bump_remaining = zone->total_size - zone->used_size;
+
+    while (chunk && iterations < MAX_CHUNKS_PER_ZONE) {
+        frag->chunks++;
+        if (chunk->is_free) {
+            frag->free_bytes += chunk->size;
+            run += run ? CHUNK_HEADER_SIZE + chunk->size : chunk->size;
+        } else {
+            frag->allocated_bytes += chunk->size;
+            close_run(frag, report, run);
+            run = 0;
+        }
+        chunk = zone_next_chunk(zone, chunk);
+        iterations++;
+    }
+    close_run(frag, report, run);
+    frag->external_fragmentation = frag_ratio(usable_bytes(frag), frag->free_bytes + frag->bump_remaining);
+}
+
+static void add_zone(t_malloc_frag_report *report, const t_malloc_zone_frag *frag, size_t *usable)
+{
+    report->zones++;
+    report->free_bytes += frag->free_bytes;
+    report->free_runs += frag->free_runs;
+    report->bump_remaining += frag->bump_remaining;
+    if (frag->largest_free_run > report->largest_free_run)
+        report->largest_free_run = frag->largest_free_run;
+    *usable += usable_bytes(frag);
+}
+
+int get_malloc_fragmentation(t_malloc_frag_report *report,
+                             t_malloc_zone_frag *zones, size_t max_zones)
+{
+    t_malloc_zone_frag frag;
+    size_t usable = 0;
+
+    if (!report || (!zones && max_zones > 0))
+        return -1;
+
+    ft_memset(report, 0, sizeof(*report));
+    malloc_lock(MALLOC_LOCK_MAINTENANCE);
+
+    for (int type = 0; type < 3; type++) {
+        t_zone *zone = g_manager.zones[type];
+        size_t count = 0;
+
+        while (zone && count < zone_list_limit(type)) {
+            measure_zone(zone, &frag, report);
+            if (report->zones < max_zones)
+                zones[report->zones] = frag;
+            add_zone(report, &frag, &usable);
+            zone = zone->next;
+            count++;
+        }
+    }
+
+    malloc_unlock();
+    report->external_fragmentation = frag_ratio(usable, report->free_bytes + report->bump_remaining);
+    return (int)report->zones;
+}
+
+static void print_permille(t_out_buffer *out, double ratio)
+{
+    size_t permille = (size_t)(ratio * 1000.0 + 0.5);
+
+    out_nbr(out, permille / 10);
+    out_char(out, '.');
+    out_nbr(out, permille % 10);
+    out_char(out, '%');
+}
+
+static void print_zone(t_out_buffer *out, const t_malloc_zone_frag *frag)
+{
+    out_str(out, g_frag_zone_names[frag->type]);
+    out_str(out, " : 0x");
+    out_hex(out, frag->start);
+    out_str(out, " free=");
+    out_nbr(out, frag->free_bytes);
+    out_str(out, " runs=");
+    out_nbr(out, frag->free_runs);
+    out_str(out, " largest=");
+    out_nbr(out, frag->largest_free_run);
+    out_str(out, " bump=");
+    out_nbr(out, frag->bump_remaining);
+    out_str(out, " frag=");
+    print_permille(out, frag->external_fragmentation);
+    out_char(out, '\n');
+}
+
+static void print_histogram(t_out_buffer *out, const t_malloc_frag_report *report)
+{
+    for (int i = 0; i < MALLOC_FRAG_BUCKETS; i++) {
+        if (report->run_histogram[i] == 0)
+            continue;
+        out_str(out, "  runs ");
+        out_str(out, i == 0 ? "<" : ">=");
+        out_nbr(out, (size_t)1 << (i == 0 ? 5 : i + 4));
+        out_str(out, ": ");
+        out_nbr(out, report->run_histogram[i]);
+        out_char(out, '\n');
+    }
+}
+
+void show_malloc_fragmentation(void)
+{
+    t_malloc_zone_frag zones[64];
+    t_malloc_frag_report report;
+    t_out_buffer out;
+
+    int count = get_malloc_fragmentation(&report, zones, 64);
+    out_init(&out, 1);
+    out_str(&out, "=== Fragmentation ===\n");
+
+    for (int i = 0; i < count && i < 64; i++)
+        print_zone(&out, &zones[i]);
+
+    out_str(&out, "Total: free=");
+    out_nbr(&out, report.free_bytes);
+    out_str(&out, " runs=");
+    out_nbr(&out, report.free_runs);
+    out_str(&out, " largest=");
+    out_nbr(&out, report.largest_free_run);
+    out_str(&out, " bump=");
+    out_nbr(&out, report.bump_remaining);
+    out_str(&out, " frag=");
+    print_permille(&out, report.external_fragmentation);
+    out_char(&out, '\n');
+    print_histogram(&out, &report);
+
+    if (count > 64) {
+        out_str(&out, "  ... ");
+        out_nbr(&out, count - 64);
+        out_str(&out, " more zones\n");
+    }
+    out_flush(&out);
+}
@@ -0,0 +1,149 @@
+#include "../../include/malloc_internal.h"
+
+typedef struct {
+    void *start;
+    size_t size;
+    int type;
+    int created;
+} t_hook_zone_event;
+
+static pthread_mutex_t g_hooks_lock = PTHREAD_MUTEX_INITIALIZER;
+static t_malloc_hooks g_hooks[MALLOC_HOOKS_MAX];
+static int g_hooks_used[MALLOC_HOOKS_MAX];
+static int g_hooks_readers[MALLOC_HOOKS_MAX];
+static __thread int g_hook_depth = 0;
+static __thread t_hook_zone_event g_hook_zones[HOOK_ZONE_QUEUE];
+static __thread int g_hook_zone_count = 0;
+
+int malloc_hooks_register(const t_malloc_hooks *hooks)
+{
+    int id = -1;
+
+    if (!hooks)
+        return -1;
+
+    lock_acquire(&g_hooks_lock, MALLOC_LOCK_HOOKS);
+    for (int i = 0; i < MALLOC_HOOKS_MAX && id < 0; i++) {
+        if (!g_hooks_used[i] && !__atomic_load_n(&g_hooks_readers[i], __ATOMIC_SEQ_CST))
+            id = i;
+    }
+    if (id >= 0) {
+        g_hooks[id] = *hooks;
+        __atomic_store_n(&g_hooks_used[id], 1, __ATOMIC_SEQ_CST);
+        STAT_ATOMIC_ADD(g_manager.hook_count, 1);
+    }
+    pthread_mutex_unlock(&g_hooks_lock);
+    return id;
+}
+
+int malloc_hooks_unregister(int id)
+{
+    int result = -1;
+
+    if (id < 0 || id >= MALLOC_HOOKS_MAX)
+        return -1;
+
+    lock_acquire(&g_hooks_lock, MALLOC_LOCK_HOOKS);
+    if (g_hooks_used[id]) {
+        __atomic_store_n(&g_hooks_used[id], 0, __ATOMIC_SEQ_CST);
+        STAT_ATOMIC_SUB(g_manager.hook_count, 1);
+        result = 0;
+    }
+    pthread_mutex_unlock(&g_hooks_lock);
+    return result;
+}
+
+static t_malloc_hooks *hooks_acquire(int i)
+{
+    __atomic_fetch_add(&g_hooks_readers[i], 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&g_hooks_used[i], __ATOMIC_SEQ_CST))
+        return &g_hooks[i];
+    __atomic_fetch_sub(&g_hooks_readers[i], 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+static void hooks_release(int i)
+{
+    __atomic_fetch_sub(&g_hooks_readers[i], 1, __ATOMIC_RELEASE);
+}
+
+static void dispatch_zone(const t_hook_zone_event *event)
+{
+    for (int i = 0; i < MALLOC_HOOKS_MAX; i++) {
+        t_malloc_hooks *hooks = hooks_acquire(i);
+        if (!hooks)
+            continue;
+        if (event->created && hooks->on_zone_create)
+            hooks->on_zone_create(hooks->arg, event->start, event->size, event->type);
+        else if (!event->created && hooks->on_zone_destroy)
+            hooks->on_zone_destroy(hooks->arg, event->start, event->size, event->type);
+        hooks_release(i);
+    }
+}
+
+static void dispatch_op(t_malloc_op op, void *ptr, void *old_ptr, size_t size)
+{
+    for (int i = 0; i < MALLOC_HOOKS_MAX; i++) {
+        t_malloc_hooks *hooks = hooks_acquire(i);
+        if (!hooks)
+            continue;
+        if (op == MALLOC_OP_MALLOC && hooks->on_malloc)
+            hooks->on_malloc(hooks->arg, ptr, size);
+        else if (op == MALLOC_OP_FREE && hooks->on_free)
+            hooks->on_free(hooks->arg, old_ptr);
+        else if (op == MALLOC_OP_REALLOC && hooks->on_realloc)
+            hooks->on_realloc(hooks->arg, old_ptr, ptr, size);
+        hooks_release(i);
+    }
+}
+
+static void drain_zones(void)
+{
+    for (int i = 0; i < g_hook_zone_count; i++)
+        dispatch_zone(&g_hook_zones[i]);
+    g_hook_zone_count = 0;
+}
+
+int hook_enter(void)
+{
+    return g_hook_depth++ > 0 ? HOOK_NESTED : HOOK_FIRE;
+}
+
+void hook_end(int state, t_malloc_op op, void *ptr, void *old_ptr, size_t size)
+{
+    if (state == HOOK_FIRE) {
+        int happened = op == MALLOC_OP_FREE ? old_ptr != NULL : ptr != NULL;
+        if (op != MALLOC_OP_FREE)
+            drain_zones();
+        if (happened)
+            dispatch_op(op, ptr, old_ptr, size);
+        drain_zones();
+    }
+    g_hook_depth--;
+}
+
+void hook_note_zone(t_zone *zone, int created)
+{
+    if (!STAT_LOAD(g_manager.hook_count))
+        return;
+    if (g_hook_zone_count >= HOOK_ZONE_QUEUE) {
+        STAT_ADD(g_manager.stats.hook_events_dropped, 1);
+        return;
+    }
+
+    t_hook_zone_event *event = &g_hook_zones[g_hook_zone_count++];
+    event->start = zone->start;
+    event->size = zone->total_size;
+    event->type = zone->type;
+    event->created = created;
+}
+
+void hook_flush(void)
+{
+    if (g_hook_depth > 0 || g_hook_zone_count == 0)
+        return;
+
+    g_hook_depth++;
+    drain_zones();
+    g_hook_depth--;
+}
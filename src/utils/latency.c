@@ -0,0 +1,174 @@
+#define _GNU_SOURCE
+#include "../../include/malloc_internal.h"
+#include <stdint.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+# define LATENCY_HAS_TSC 1
+# include <x86intrin.h>
+#else
+# define LATENCY_HAS_TSC 0
+#endif
+
+static t_malloc_latency g_latency;
+static __thread int g_latency_depth = 0;
+static __thread uint64_t g_latency_mmaps = 0;
+static __thread uint64_t g_latency_munmaps = 0;
+
+static uint64_t latency_now(void)
+{
+#if LATENCY_HAS_TSC
+    return __rdtsc();
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+static int latency_bucket(uint64_t value)
+{
+    if (value == 0)
+        return 0;
+    return 64 - __builtin_clzll(value);
+}
+
+uint64_t latency_begin(void)
+{
+    if (!STAT_LOAD(g_manager.config.latency_enabled))
+        return LATENCY_OFF;
+
+    if (g_latency_depth++ > 0)
+        return LATENCY_NESTED;
+
+    g_latency_mmaps = 0;
+    g_latency_munmaps = 0;
+    uint64_t now = latency_now();
+    return now > LATENCY_NESTED ? now : LATENCY_NESTED + 1;
+}
+
+void latency_end(t_malloc_op op, int zone_type, uint64_t start)
+{
+    if (start == LATENCY_OFF)
+        return;
+
+    g_latency_depth--;
+    if (start == LATENCY_NESTED)
+        return;
+
+    uint64_t now = latency_now();
+    uint64_t elapsed = now > start ? now - start : 0;
+    t_malloc_latency_hist *hist = &g_latency.ops[op][zone_type];
+    int bucket = latency_bucket(elapsed);
+
+    if (bucket >= MALLOC_LATENCY_BUCKETS)
+        bucket = MALLOC_LATENCY_BUCKETS - 1;
+
+    STAT_ATOMIC_ADD(hist->count, 1);
+    STAT_ATOMIC_ADD(hist->total, elapsed);
+    STAT_ATOMIC_ADD(hist->buckets[bucket], 1);
+    STAT_ATOMIC_ADD(hist->mmap_calls, g_latency_mmaps);
+    STAT_ATOMIC_ADD(hist->munmap_calls, g_latency_munmaps);
+
+    uint64_t max = STAT_LOAD(hist->max);
+    while (elapsed > max && !__atomic_compare_exchange_n(&hist->max, &max,
+           elapsed, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        ;
+}
+
+void latency_note_mmap(void)
+{
+    if (g_latency_depth > 0)
+        g_latency_mmaps++;
+}
+
+void latency_note_munmap(void)
+{
+    if (g_latency_depth > 0)
+        g_latency_munmaps++;
+}
+
+int get_malloc_latency(t_malloc_latency *latency)
+{
+    if (!latency)
+        return -1;
+
+    uint64_t *dst = (uint64_t *)latency->ops;
+    uint64_t *src = (uint64_t *)g_latency.ops;
+    size_t words = sizeof(g_latency.ops) / sizeof(uint64_t);
+
+    for (size_t i = 0; i < words; i++)
+        dst[i] = STAT_LOAD(src[i]);
+
+    latency->unit_cycles = LATENCY_HAS_TSC;
+    return 0;
+}
+
+void malloc_latency_reset(void)
+{
+    uint64_t *words = (uint64_t *)g_latency.ops;
+    size_t count = sizeof(g_latency.ops) / sizeof(uint64_t);
+
+    for (size_t i = 0; i < count; i++)
+        __atomic_store_n(&words[i], 0, __ATOMIC_RELAXED);
+}
+
+static uint64_t latency_percentile(const t_malloc_latency_hist *hist,
+                                   uint64_t per_mille)
+{
+    uint64_t rank = (hist->count * per_mille + 999) / 1000;
+    uint64_t seen = 0;
+
+    for (int i = 0; i < MALLOC_LATENCY_BUCKETS; i++) {
+        seen += hist->buckets[i];
+        if (seen >= rank && seen > 0)
+            return i == 0 ? 0 : (1ULL << i) - 1;
+    }
+    return hist->max;
+}
+
+static void print_latency_row(t_out_buffer *out, const char *op,
+                              const char *zone, const t_malloc_latency_hist *hist)
+{
+    out_str(out, op);
+    out_char(out, ' ');
+    out_str(out, zone);
+    out_str(out, ": count=");
+    out_nbr(out, hist->count);
+    out_str(out, " avg=");
+    out_nbr(out, hist->total / hist->count);
+    out_str(out, " p50<=");
+    out_nbr(out, latency_percentile(hist, 500));
+    out_str(out, " p99<=");
+    out_nbr(out, latency_percentile(hist, 990));
+    out_str(out, " max=");
+    out_nbr(out, hist->max);
+    out_str(out, " mmap=");
+    out_nbr(out, hist->mmap_calls);
+    out_str(out, " munmap=");
+    out_nbr(out, hist->munmap_calls);
+    out_char(out, '\n');
+}
+
+void show_malloc_latency(void)
+{
+    static const char *ops[MALLOC_LATENCY_OPS] = {"malloc", "free", "realloc"};
+    static const char *zones[3] = {"TINY", "SMALL", "LARGE"};
+    t_malloc_latency latency;
+    t_out_buffer out;
+
+    get_malloc_latency(&latency);
+    out_init(&out, 1);
+    out_str(&out, "=== Allocation Latency (");
+    out_str(&out, latency.unit_cycles ? "cycles" : "ns");
+    out_str(&out, ") ===\n");
+
+    for (int op = 0; op < MALLOC_LATENCY_OPS; op++) {
+        for (int type = 0; type < 3; type++) {
+            if (latency.ops[op][type].count > 0)
+                print_latency_row(&out, ops[op], zones[type], &latency.ops[op][type]);
+        }
+    }
+    out_flush(&out);
+}
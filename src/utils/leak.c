@@ -0,0 +1,175 @@
+#define _GNU_SOURCE
+#include "../../include/malloc_internal.h"
+#include <dlfcn.h>
+#include <stdint.h>
+
+typedef struct {
+    void *ptr;
+    void *site;
+} t_leak_entry;
+
+typedef struct {
+    void *site;
+    size_t count;
+    size_t bytes;
+} t_leak_site;
+
+static t_ptr_table g_leak_table = {NULL, sizeof(t_leak_entry), 0, 0};
+
+void leak_track(t_chunk *chunk, void *site)
+{
+    if (!g_manager.config.leak_report)
+        return;
+
+    t_leak_entry *entry = ptr_table_insert(&g_leak_table, get_user_ptr(chunk));
+    if (!entry)
+        return;
+
+    entry->site = site;
+    chunk->flags |= CHUNK_FLAG_TRACKED;
+}
+
+uintptr_t leak_chunk_site(t_chunk *chunk)
+{
+    if (!(chunk->flags & CHUNK_FLAG_TRACKED))
+        return 0;
+
+    t_leak_entry *entry = ptr_table_find(&g_leak_table, get_user_ptr(chunk));
+    return entry ? (uintptr_t)entry->site : 0;
+}
+
+void leak_forget_chunk(t_chunk *chunk)
+{
+    if (!(chunk->flags & CHUNK_FLAG_TRACKED))
+        return;
+
+    chunk->flags &= ~CHUNK_FLAG_TRACKED;
+    ptr_table_remove(&g_leak_table, get_user_ptr(chunk));
+}
+
+void leak_reset(void)
+{
+    ptr_table_clear(&g_leak_table);
+}
+
+static void group_by_site(t_ptr_table *sites, size_t *total_count, size_t *total_bytes)
+{
+    size_t cursor = 0;
+    t_leak_entry *entry;
+
+    while ((entry = ptr_table_next(&g_leak_table, &cursor)) != NULL) {
+        t_chunk *chunk = get_chunk_from_ptr(entry->ptr);
+        size_t bytes = chunk->size - chunk->slack;
+        void *key = entry->site ? entry->site : (void *)&g_leak_table;
+        t_leak_site *site = ptr_table_insert(sites, key);
+
+        if (!site)
+            continue;
+        site->count++;
+        site->bytes += bytes;
+        *total_count += 1;
+        *total_bytes += bytes;
+    }
+}
+
+static t_leak_site *take_largest(t_ptr_table *sites)
+{
+    t_leak_site *largest = NULL;
+    size_t cursor = 0;
+    t_leak_site *site;
+
+    while ((site = ptr_table_next(sites, &cursor)) != NULL) {
+        if (site->count && (!largest || site->bytes > largest->bytes))
+            largest = site;
+    }
+    return largest;
+}
+
+static void print_site(t_out_buffer *out, const t_leak_site *site)
+{
+    Dl_info info;
+
+    out_str(out, "  ");
+    out_nbr(out, site->bytes);
+    out_str(out, " bytes in ");
+    out_nbr(out, site->count);
+    out_str(out, " allocations from ");
+
+    if (site->site == (void *)&g_leak_table) {
+        out_str(out, "<unknown>\n");
+        return;
+    }
+
+    int resolved = dladdr(site->site, &info);
+    if (resolved && info.dli_sname) {
+        out_str(out, info.dli_sname);
+        out_str(out, "+0x");
+        out_hex(out, (uintptr_t)site->site - (uintptr_t)info.dli_saddr);
+    } else {
+        out_str(out, "0x");
+        out_hex(out, (uintptr_t)site->site);
+    }
+
+    if (resolved && info.dli_fname) {
+        out_str(out, " (");
+        out_str(out, info.dli_fname);
+        out_char(out, ')');
+    }
+    out_char(out, '\n');
+}
+
+static void print_report(t_out_buffer *out, t_ptr_table *sites,
+                         size_t total_count, size_t total_bytes)
+{
+    size_t shown = 0;
+    t_leak_site *site;
+
+    out_str(out, "=== Leak Report: ");
+    out_nbr(out, total_bytes);
+    out_str(out, " bytes in ");
+    out_nbr(out, total_count);
+    out_str(out, " allocations from ");
+    out_nbr(out, sites->count);
+    out_str(out, " sites ===\n");
+
+    while (shown < LEAK_REPORT_MAX_SITES && (site = take_largest(sites)) != NULL) {
+        print_site(out, site);
+        site->count = 0;
+        shown++;
+    }
+
+    if (sites->count > shown) {
+        out_str(out, "  ... ");
+        out_nbr(out, sites->count - shown);
+        out_str(out, " more sites\n");
+    }
+}
+
+int malloc_leak_report(int fd)
+{
+    t_ptr_table sites = {NULL, sizeof(t_leak_site), 0, 0};
+    size_t total_count = 0;
+    size_t total_bytes = 0;
+    t_out_buffer out;
+
+    if (fd < 0)
+        return -1;
+
+    malloc_lock(MALLOC_LOCK_MAINTENANCE);
+    group_by_site(&sites, &total_count, &total_bytes);
+    malloc_unlock();
+
+    out_init(&out, fd);
+    print_report(&out, &sites, total_count, total_bytes);
+    out_flush(&out);
+
+    ptr_table_clear(&sites);
+    return (int)total_count;
+}
+
+__attribute__((destructor))
+static void leak_report_at_exit(void)
+{
+    if (g_manager.config.leak_report && g_leak_table.count > 0)
+        malloc_leak_report(2);
+}
@@ -0,0 +1,153 @@
+#define _GNU_SOURCE
+#include "../../include/malloc_internal.h"
+#include <time.h>
+
+#define LOCK_GLOBAL_SITES (MALLOC_LOCK_MAINTENANCE + 1)
+
+static t_malloc_lock_site_stats g_lock_sites[MALLOC_LOCK_SITES];
+static int g_lock_holder = -1;
+
+static uint64_t lock_clock(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t lock_wait(pthread_mutex_t *mutex)
+{
+    uint64_t start = lock_clock();
+
+    pthread_mutex_lock(mutex);
+    uint64_t end = lock_clock();
+    return end > start ? end - start : 0;
+}
+
+static void lock_update_max(t_malloc_lock_site_stats *site, uint64_t wait)
+{
+    uint64_t max = STAT_LOAD(site->wait_max_ns);
+
+    while (wait > max && !__atomic_compare_exchange_n(&site->wait_max_ns, &max,
+           wait, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        ;
+}
+
+void malloc_lock(t_malloc_lock_site site)
+{
+    t_malloc_lock_site_stats *stats = &g_lock_sites[site];
+
+    if (pthread_mutex_trylock(&g_mutex) != 0) {
+        int holder = __atomic_load_n(&g_lock_holder, __ATOMIC_RELAXED);
+        if (holder >= 0)
+            STAT_ATOMIC_ADD(g_lock_sites[holder].held_while_contended, 1);
+
+        uint64_t wait = lock_wait(&g_mutex);
+        STAT_ADD(stats->contended, 1);
+        STAT_ADD(stats->wait_ns, wait);
+        lock_update_max(stats, wait);
+    }
+
+    STAT_ADD(stats->acquisitions, 1);
+    __atomic_store_n(&g_lock_holder, site, __ATOMIC_RELAXED);
+}
+
+void malloc_unlock(void)
+{
+    __atomic_store_n(&g_lock_holder, -1, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&g_mutex);
+    thread_stats_attach();
+}
+
+void lock_acquire(pthread_mutex_t *mutex, t_malloc_lock_site site)
+{
+    t_malloc_lock_site_stats *stats = &g_lock_sites[site];
+
+    if (pthread_mutex_trylock(mutex) != 0) {
+        uint64_t wait = lock_wait(mutex);
+        STAT_ATOMIC_ADD(stats->contended, 1);
+        STAT_ATOMIC_ADD(stats->wait_ns, wait);
+        lock_update_max(stats, wait);
+    }
+
+    STAT_ATOMIC_ADD(stats->acquisitions, 1);
+}
+
+int get_malloc_lock_stats(t_malloc_lock_stats *stats)
+{
+    if (!stats)
+        return -1;
+
+    ft_memset(stats, 0, sizeof(t_malloc_lock_stats));
+
+    for (int i = 0; i < MALLOC_LOCK_SITES; i++) {
+        t_malloc_lock_site_stats *site = &stats->sites[i];
+
+        site->acquisitions = STAT_LOAD(g_lock_sites[i].acquisitions);
+        site->contended = STAT_LOAD(g_lock_sites[i].contended);
+        site->wait_ns = STAT_LOAD(g_lock_sites[i].wait_ns);
+        site->wait_max_ns = STAT_LOAD(g_lock_sites[i].wait_max_ns);
+        site->held_while_contended = STAT_LOAD(g_lock_sites[i].held_while_contended);
+
+        if (i < LOCK_GLOBAL_SITES) {
+            stats->acquisitions += site->acquisitions;
+            stats->contended += site->contended;
+            stats->wait_ns += site->wait_ns;
+        }
+    }
+
+    return 0;
+}
+
+void malloc_lock_stats_reset(void)
+{
+    uint64_t *words = (uint64_t *)g_lock_sites;
+    size_t count = MALLOC_LOCK_SITES * sizeof(t_malloc_lock_site_stats) / sizeof(uint64_t);
+
+    for (size_t i = 0; i < count; i++)
+        __atomic_store_n(&words[i], 0, __ATOMIC_RELAXED);
+}
+
+static void print_site(t_out_buffer *out, const char *name,
+                       const t_malloc_lock_site_stats *site)
+{
+    out_str(out, name);
+    out_str(out, ": acquired=");
+    out_nbr(out, site->acquisitions);
+    out_str(out, " contended=");
+    out_nbr(out, site->contended);
+    out_str(out, " wait_ns=");
+    out_nbr(out, site->wait_ns);
+    out_str(out, " max_wait_ns=");
+    out_nbr(out, site->wait_max_ns);
+    out_str(out, " blocked_others=");
+    out_nbr(out, site->held_while_contended);
+    out_char(out, '\n');
+}
+
+void show_malloc_lock_stats(void)
+{
+    static const char *names[MALLOC_LOCK_SITES] = {
+        "malloc", "free", "realloc", "aligned", "pool zone",
+        "config", "maintenance", "pool (per-pool lock)", "prof (profiler lock)",
+        "trace (recorder lock)", "hooks (registry lock)"
+    };
+    t_malloc_lock_stats stats;
+    t_out_buffer out;
+
+    get_malloc_lock_stats(&stats);
+    out_init(&out, 1);
+    out_str(&out, "=== Lock Contention ===\nglobal: acquired=");
+    out_nbr(&out, stats.acquisitions);
+    out_str(&out, " contended=");
+    out_nbr(&out, stats.contended);
+    out_str(&out, " wait_ns=");
+    out_nbr(&out, stats.wait_ns);
+    out_char(&out, '\n');
+
+    for (int i = 0; i < MALLOC_LOCK_SITES; i++) {
+        if (stats.sites[i].acquisitions > 0)
+            print_site(&out, names[i], &stats.sites[i]);
+    }
+    out_flush(&out);
+}
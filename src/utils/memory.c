@@ -1,28 +1,276 @@
 #include "../../include/malloc_internal.h"
+#include <stdint.h>
 
-void *ft_memcpy(void *dst, const void *src, size_t n)
+#if defined(__x86_64__) || defined(__i386__)
+# define MEMORY_HAS_SIMD 1
+# include <immintrin.h>
+#else
+# define MEMORY_HAS_SIMD 0
+#endif
+
+typedef void *(*t_memcpy_fn)(void *dst, const void *src, size_t n);
+typedef void *(*t_memset_fn)(void *b, int c, size_t len);
+
+static void *memcpy_resolve(void *dst, const void *src, size_t n);
+static void *memset_resolve(void *b, int c, size_t len);
+
+static t_memcpy_fn g_memcpy_impl = memcpy_resolve;
+static t_memset_fn g_memset_impl = memset_resolve;
+static int g_memory_kernel = MEMORY_KERNEL_WORDS;
+
+static void *memcpy_words(void *dst, const void *src, size_t n)
 {
 	unsigned char *d = (unsigned char *)dst;
 	const unsigned char *s = (const unsigned char *)src;
-	size_t i = 0;
+	uint64_t word;
 
-	while (i < n) {
-		d[i] = s[i];
-		i++;
+	while (n > 0 && ((uintptr_t)d & (sizeof(word) - 1))) {
+		*d++ = *s++;
+		n--;
+	}
+
+	while (n >= sizeof(word)) {
+		__builtin_memcpy(&word, s, sizeof(word));
+		__builtin_memcpy(d, &word, sizeof(word));
+		d += sizeof(word);
+		s += sizeof(word);
+		n -= sizeof(word);
+	}
+
+	while (n > 0) {
+		*d++ = *s++;
+		n--;
 	}
 
 	return dst;
 }
 
-void *ft_memset(void *b, int c, size_t len)
+static void *memset_words(void *b, int c, size_t len)
 {
 	unsigned char *ptr = (unsigned char *)b;
-	size_t i = 0;
+	uint64_t word = (uint64_t)(unsigned char)c * 0x0101010101010101ULL;
 
-	while (i < len) {
-		ptr[i] = (unsigned char)c;
-		i++;
+	while (len > 0 && ((uintptr_t)ptr & (sizeof(word) - 1))) {
+		*ptr++ = (unsigned char)c;
+		len--;
+	}
+
+	while (len >= sizeof(word)) {
+		__builtin_memcpy(ptr, &word, sizeof(word));
+		ptr += sizeof(word);
+		len -= sizeof(word);
+	}
+
+	while (len > 0) {
+		*ptr++ = (unsigned char)c;
+		len--;
 	}
 
 	return b;
 }
+
+#if MEMORY_HAS_SIMD
+
+__attribute__((target("sse2")))
+static void *memcpy_sse2(void *dst, const void *src, size_t n)
+{
+	if (n < 2 * sizeof(__m128i))
+		return memcpy_words(dst, src, n);
+
+	unsigned char *d = (unsigned char *)dst;
+	const unsigned char *s = (const unsigned char *)src;
+	__m128i tail = _mm_loadu_si128((const __m128i *)(s + n - 16));
+	size_t skew = 16 - ((uintptr_t)d & 15);
+
+	_mm_storeu_si128((__m128i *)d, _mm_loadu_si128((const __m128i *)s));
+	d += skew;
+	s += skew;
+	n -= skew;
+
+	if (n >= MEMORY_NT_THRESHOLD) {
+		for (; n >= 16; d += 16, s += 16, n -= 16)
+			_mm_stream_si128((__m128i *)d, _mm_loadu_si128((const __m128i *)s));
+		_mm_sfence();
+	} else {
+		for (; n >= 16; d += 16, s += 16, n -= 16)
+			_mm_store_si128((__m128i *)d, _mm_loadu_si128((const __m128i *)s));
+	}
+
+	if (n > 0)
+		_mm_storeu_si128((__m128i *)(d + n - 16), tail);
+	return dst;
+}
+
+__attribute__((target("sse2")))
+static void *memset_sse2(void *b, int c, size_t len)
+{
+	if (len < 2 * sizeof(__m128i))
+		return memset_words(b, c, len);
+
+	unsigned char *ptr = (unsigned char *)b;
+	__m128i value = _mm_set1_epi8((char)c);
+	size_t skew = 16 - ((uintptr_t)ptr & 15);
+
+	_mm_storeu_si128((__m128i *)ptr, value);
+	_mm_storeu_si128((__m128i *)(ptr + len - 16), value);
+	ptr += skew;
+	len -= skew;
+
+	if (len >= MEMORY_NT_THRESHOLD) {
+		for (; len >= 16; ptr += 16, len -= 16)
+			_mm_stream_si128((__m128i *)ptr, value);
+		_mm_sfence();
+	} else {
+		for (; len >= 16; ptr += 16, len -= 16)
+			_mm_store_si128((__m128i *)ptr, value);
+	}
+
+	return b;
+}
+
+__attribute__((target("avx2")))
+static void *memcpy_avx2(void *dst, const void *src, size_t n)
+{
+	if (n < 2 * sizeof(__m256i))
+		return memcpy_sse2(dst, src, n);
+
+	unsigned char *d = (unsigned char *)dst;
+	const unsigned char *s = (const unsigned char *)src;
+	__m256i tail = _mm256_loadu_si256((const __m256i *)(s + n - 32));
+	size_t skew = 32 - ((uintptr_t)d & 31);
+
+	_mm256_storeu_si256((__m256i *)d, _mm256_loadu_si256((const __m256i *)s));
+	d += skew;
+	s += skew;
+	n -= skew;
+
+	if (n >= MEMORY_NT_THRESHOLD) {
+		for (; n >= 32; d += 32, s += 32, n -= 32)
+			_mm256_stream_si256((__m256i *)d, _mm256_loadu_si256((const __m256i *)s));
+		_mm_sfence();
+	} else {
+		for (; n >= 32; d += 32, s += 32, n -= 32)
+			_mm256_store_si256((__m256i *)d, _mm256_loadu_si256((const __m256i *)s));
+	}
+
+	if (n > 0)
+		_mm256_storeu_si256((__m256i *)(d + n - 32), tail);
+	return dst;
+}
+
+__attribute__((target("avx2")))
+static void *memset_avx2(void *b, int c, size_t len)
+{
+	if (len < 2 * sizeof(__m256i))
+		return memset_sse2(b, c, len);
+
+	unsigned char *ptr = (unsigned char *)b;
+	__m256i value = _mm256_set1_epi8((char)c);
+	size_t skew = 32 - ((uintptr_t)ptr & 31);
+
+	_mm256_storeu_si256((__m256i *)ptr, value);
+	_mm256_storeu_si256((__m256i *)(ptr + len - 32), value);
+	ptr += skew;
+	len -= skew;
+
+	if (len >= MEMORY_NT_THRESHOLD) {
+		for (; len >= 32; ptr += 32, len -= 32)
+			_mm256_stream_si256((__m256i *)ptr, value);
+		_mm_sfence();
+	} else {
+		for (; len >= 32; ptr += 32, len -= 32)
+			_mm256_store_si256((__m256i *)ptr, value);
+	}
+
+	return b;
+}
+
+#endif
+
+static int memory_kernel_supported(int kernel)
+{
+	if (kernel == MEMORY_KERNEL_WORDS)
+		return 1;
+#if MEMORY_HAS_SIMD
+	__builtin_cpu_init();
+	if (kernel == MEMORY_KERNEL_AVX2)
+		return __builtin_cpu_supports("avx2");
+	if (kernel == MEMORY_KERNEL_SSE2)
+		return __builtin_cpu_supports("sse2");
+#endif
+	return 0;
+}
+
+static void memory_apply_kernel(int kernel)
+{
+	t_memcpy_fn copy = memcpy_words;
+	t_memset_fn set = memset_words;
+
+#if MEMORY_HAS_SIMD
+	if (kernel == MEMORY_KERNEL_AVX2) {
+		copy = memcpy_avx2;
+		set = memset_avx2;
+	} else if (kernel == MEMORY_KERNEL_SSE2) {
+		copy = memcpy_sse2;
+		set = memset_sse2;
+	}
+#endif
+
+	g_memcpy_impl = copy;
+	g_memset_impl = set;
+	g_memory_kernel = kernel;
+}
+
+__attribute__((constructor))
+static void memory_select_kernels(void)
+{
+	int kernel = MEMORY_KERNEL_AVX2;
+
+	while (kernel > MEMORY_KERNEL_WORDS && !memory_kernel_supported(kernel))
+		kernel--;
+	memory_apply_kernel(kernel);
+}
+
+int memory_kernel(void)
+{
+	return g_memory_kernel;
+}
+
+int memory_use_kernel(size_t kernel)
+{
+	if (kernel > MEMORY_KERNEL_AVX2 || !memory_kernel_supported((int)kernel))
+		return -1;
+	memory_apply_kernel((int)kernel);
+	return 0;
+}
+
+static void *memcpy_resolve(void *dst, const void *src, size_t n)
+{
+	memory_select_kernels();
+	return g_memcpy_impl(dst, src, n);
+}
+
+static void *memset_resolve(void *b, int c, size_t len)
+{
+	memory_select_kernels();
+	return g_memset_impl(b, c, len);
+}
+
+void *ft_memcpy(void *dst, const void *src, size_t n)
+{
+	return g_memcpy_impl(dst, src, n);
+}
+
+void *ft_memset(void *b, int c, size_t len)
+{
+	return g_memset_impl(b, c, len);
+}
+
+int ft_strequal(const char *a, const char *b)
+{
+	size_t i = 0;
+
+	while (a[i] && a[i] == b[i] && i < 256)
+		i++;
+	return a[i] == b[i];
+}
@@ -1,27 +1,50 @@
 #include "../../include/malloc_internal.h"
 #include <unistd.h>
 
-static void put_char(char c)
+void out_init(t_out_buffer *out, int fd)
 {
-	write(1, &c, 1);
+	out->fd = fd;
+	out->len = 0;
 }
 
-static void put_str(const char *str)
+void out_flush(t_out_buffer *out)
+{
+	size_t done = 0;
+	int retries = 0;
+
+	while (done < out->len && retries < 100) {
+		ssize_t written = write(out->fd, out->data + done, out->len - done);
+		if (written <= 0)
+			retries++;
+		else
+			done += (size_t)written;
+	}
+	out->len = 0;
+}
+
+void out_char(t_out_buffer *out, char c)
+{
+	if (out->len == OUT_BUFFER_SIZE)
+		out_flush(out);
+	out->data[out->len++] = c;
+}
+
+void out_str(t_out_buffer *out, const char *str)
 {
 	int i = 0;
 
 	while (str[i])
-		put_char(str[i++]);
+		out_char(out, str[i++]);
 }
 
-static void put_hex(unsigned long n)
+void out_hex(t_out_buffer *out, unsigned long n)
 {
 	char hex_digits[] = "0123456789ABCDEF";
 	char buffer[16];
 	int i = 0;
 
 	if (n == 0) {
-		put_char('0');
+		out_char(out, '0');
 		return;
 	}
 
@@ -31,16 +54,16 @@ static void put_hex(unsigned long n)
 	}
 
 	while (i > 0)
-		put_char(buffer[--i]);
+		out_char(out, buffer[--i]);
 }
 
-static void put_nbr(size_t n)
+void out_nbr(t_out_buffer *out, size_t n)
 {
 	char buffer[20];
 	int i = 0;
 
 	if (n == 0) {
-		put_char('0');
+		out_char(out, '0');
 		return;
 	}
 
@@ -50,31 +73,21 @@ static void put_nbr(size_t n)
 	}
 
 	while (i > 0)
-		put_char(buffer[--i]);
+		out_char(out, buffer[--i]);
 }
 
-void print_zone_header(const char *zone_name, void *address)
+void out_bytes(t_out_buffer *out, const void *data, size_t len)
 {
-	put_str(zone_name);
-	put_str(" : 0x");
-	put_hex((unsigned long)address);
-	put_char('\n');
-}
+	const char *bytes = (const char *)data;
 
-void print_allocation(void *start, void *end, size_t size)
-{
-	put_str("0x");
-	put_hex((unsigned long)start);
-	put_str(" - 0x");
-	put_hex((unsigned long)end);
-	put_str(" : ");
-	put_nbr(size);
-	put_str(" bytes\n");
-}
-
-void print_total(size_t total)
-{
-	put_str("Total : ");
-	put_nbr(total);
-	put_str(" bytes\n");
+	while (len > 0) {
+		if (out->len == OUT_BUFFER_SIZE)
+			out_flush(out);
+		size_t room = OUT_BUFFER_SIZE - out->len;
+		size_t n = len < room ? len : room;
+		ft_memcpy(out->data + out->len, bytes, n);
+		out->len += n;
+		bytes += n;
+		len -= n;
+	}
 }
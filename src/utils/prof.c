@@ -0,0 +1,209 @@
+#define _GNU_SOURCE
+#include "../../include/malloc_internal.h"
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <unistd.h>
+
+typedef struct {
+    void *ptr;
+    size_t size;
+    uintptr_t site;
+    size_t depth;
+    void *frames[PROF_MAX_FRAMES];
+} t_prof_sample;
+
+static pthread_mutex_t g_prof_lock = PTHREAD_MUTEX_INITIALIZER;
+static t_ptr_table g_prof_table = {NULL, sizeof(t_prof_sample), 0, 0};
+static __thread size_t g_prof_countdown = 0;
+static __thread uint64_t g_prof_rng = 0;
+static __thread int g_prof_busy = 0;
+
+static uint64_t prof_random(void)
+{
+    if (!g_prof_rng)
+        g_prof_rng = ((uint64_t)(uintptr_t)&g_prof_rng * 0x9E3779B97F4A7C15ULL) | 1;
+
+    g_prof_rng ^= g_prof_rng << 13;
+    g_prof_rng ^= g_prof_rng >> 7;
+    g_prof_rng ^= g_prof_rng << 17;
+    return g_prof_rng;
+}
+
+static size_t prof_next_interval(size_t period)
+{
+    uint64_t q = (prof_random() >> 38) + 1;
+    int exponent = 63 - __builtin_clzll(q);
+    double mantissa = (double)q / (double)((uint64_t)1 << exponent) - 1.0;
+    double neg_log2_u = 26.0 - ((double)exponent + mantissa);
+    double interval = neg_log2_u * 0.6931471805599453 * (double)period;
+
+    return interval < 1.0 ? 1 : (size_t)interval;
+}
+
+int prof_should_sample(size_t size)
+{
+    size_t period = g_manager.config.prof_sample;
+
+    if (period == 0 || g_prof_busy)
+        return 0;
+
+    if (g_prof_countdown == 0)
+        g_prof_countdown = prof_next_interval(period);
+
+    if (g_prof_countdown > size) {
+        g_prof_countdown -= size;
+        return 0;
+    }
+
+    g_prof_countdown = prof_next_interval(period);
+    return 1;
+}
+
+void prof_record(void *ptr, size_t size)
+{
+    void *frames[PROF_MAX_FRAMES + 1];
+
+    g_prof_busy = 1;
+    int depth = backtrace(frames, PROF_MAX_FRAMES + 1);
+    uintptr_t site = 0;
+
+    for (int i = 1; i < depth && !site; i++) {
+        if (!prof_frame_is_internal(frames[i]))
+            site = (uintptr_t)frames[i];
+    }
+
+    lock_acquire(&g_prof_lock, MALLOC_LOCK_PROF);
+    t_prof_sample *sample = ptr_table_insert(&g_prof_table, ptr);
+    if (sample) {
+        sample->size = size;
+        sample->site = site;
+        sample->depth = depth > 1 ? (size_t)(depth - 1) : 0;
+        for (size_t i = 0; i < sample->depth; i++)
+            sample->frames[i] = frames[i + 1];
+    }
+    pthread_mutex_unlock(&g_prof_lock);
+
+    g_prof_busy = 0;
+}
+
+void prof_forget_chunk(t_chunk *chunk)
+{
+    if (!(chunk->flags & CHUNK_FLAG_SAMPLED))
+        return;
+
+    chunk->flags &= ~CHUNK_FLAG_SAMPLED;
+    lock_acquire(&g_prof_lock, MALLOC_LOCK_PROF);
+    ptr_table_remove(&g_prof_table, get_user_ptr(chunk));
+    pthread_mutex_unlock(&g_prof_lock);
+}
+
+void prof_reset(void)
+{
+    lock_acquire(&g_prof_lock, MALLOC_LOCK_PROF);
+    ptr_table_clear(&g_prof_table);
+    pthread_mutex_unlock(&g_prof_lock);
+}
+
+int prof_frame_is_internal(void *pc)
+{
+    static void *library_base = NULL;
+    Dl_info info;
+
+    if (!library_base) {
+        if (!dladdr((void *)&malloc, &info))
+            return 0;
+        library_base = info.dli_fbase;
+    }
+
+    return dladdr(pc, &info) && info.dli_fbase == library_base;
+}
+
+uintptr_t prof_sample_site(const void *ptr)
+{
+    uintptr_t site = 0;
+
+    lock_acquire(&g_prof_lock, MALLOC_LOCK_PROF);
+    t_prof_sample *sample = ptr_table_find(&g_prof_table, ptr);
+    if (sample)
+        site = sample->site;
+    pthread_mutex_unlock(&g_prof_lock);
+
+    return site;
+}
+
+static void dump_sample_line(t_out_buffer *out, size_t count, size_t bytes)
+{
+    out_nbr(out, count);
+    out_str(out, ": ");
+    out_nbr(out, bytes);
+    out_str(out, " [");
+    out_nbr(out, count);
+    out_str(out, ": ");
+    out_nbr(out, bytes);
+    out_str(out, "] @");
+}
+
+static void dump_samples(t_out_buffer *out)
+{
+    size_t cursor = 0;
+    size_t total = 0;
+    t_prof_sample *sample;
+
+    while ((sample = ptr_table_next(&g_prof_table, &cursor)) != NULL)
+        total += sample->size;
+
+    out_str(out, "heap profile: ");
+    dump_sample_line(out, g_prof_table.count, total);
+    out_str(out, " heap_v2/");
+    out_nbr(out, g_manager.config.prof_sample);
+    out_char(out, '\n');
+
+    cursor = 0;
+    while ((sample = ptr_table_next(&g_prof_table, &cursor)) != NULL) {
+        dump_sample_line(out, 1, sample->size);
+        for (size_t i = 0; i < sample->depth; i++) {
+            out_str(out, " 0x");
+            out_hex(out, (unsigned long)sample->frames[i]);
+        }
+        out_char(out, '\n');
+    }
+}
+
+static void dump_mappings(t_out_buffer *out)
+{
+    char buffer[OUT_BUFFER_SIZE];
+    int maps = open("/proc/self/maps", O_RDONLY);
+
+    out_str(out, "\nMAPPED_LIBRARIES:\n");
+    out_flush(out);
+    if (maps < 0)
+        return;
+
+    ssize_t len;
+    while ((len = read(maps, buffer, sizeof(buffer))) > 0) {
+        if (write(out->fd, buffer, (size_t)len) != len)
+            break;
+    }
+    close(maps);
+}
+
+int malloc_prof_dump(int fd)
+{
+    t_out_buffer out;
+
+    if (fd < 0)
+        return -1;
+
+    out_init(&out, fd);
+    g_prof_busy = 1;
+
+    lock_acquire(&g_prof_lock, MALLOC_LOCK_PROF);
+    dump_samples(&out);
+    pthread_mutex_unlock(&g_prof_lock);
+
+    dump_mappings(&out);
+    g_prof_busy = 0;
+    return 0;
+}
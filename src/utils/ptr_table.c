@@ -0,0 +1,129 @@
+#define _GNU_SOURCE
+#include "../../include/malloc_internal.h"
+#include <stdint.h>
+
+static size_t table_home(const t_ptr_table *table, const void *key)
+{
+    uint64_t hash = ((uint64_t)(uintptr_t)key >> 4) * 0x9E3779B97F4A7C15ULL;
+    return (size_t)(hash >> 32) & (table->capacity - 1);
+}
+
+static void **table_slot(const t_ptr_table *table, size_t index)
+{
+    return (void **)(table->slots + index * table->entry_size);
+}
+
+static size_t table_probe(const t_ptr_table *table, const void *key)
+{
+    size_t index = table_home(table, key);
+    size_t probes = 0;
+
+    while (probes < table->capacity) {
+        void *current = *table_slot(table, index);
+        if (!current || current == key)
+            return index;
+        index = (index + 1) & (table->capacity - 1);
+        probes++;
+    }
+    return table->capacity;
+}
+
+static int table_grow(t_ptr_table *table)
+{
+    size_t capacity = table->capacity ? table->capacity * 2 : PTR_TABLE_INITIAL;
+    t_ptr_table grown = *table;
+
+    grown.slots = vm_map(capacity * table->entry_size);
+    if (!grown.slots)
+        return 0;
+    grown.capacity = capacity;
+
+    for (size_t i = 0; i < table->capacity; i++) {
+        void **entry = table_slot(table, i);
+        if (!*entry)
+            continue;
+        size_t index = table_probe(&grown, *entry);
+        ft_memcpy(table_slot(&grown, index), entry, table->entry_size);
+    }
+
+    if (table->slots)
+        vm_unmap(table->slots, table->capacity * table->entry_size);
+    *table = grown;
+    return 1;
+}
+
+void *ptr_table_insert(t_ptr_table *table, void *key)
+{
+    if ((table->count + 1) * 2 > table->capacity && !table_grow(table))
+        return NULL;
+
+    size_t index = table_probe(table, key);
+    if (index == table->capacity)
+        return NULL;
+
+    void **entry = table_slot(table, index);
+    if (!*entry) {
+        ft_memset(entry, 0, table->entry_size);
+        *entry = key;
+        table->count++;
+    }
+    return entry;
+}
+
+void *ptr_table_find(const t_ptr_table *table, const void *key)
+{
+    if (!table->capacity)
+        return NULL;
+
+    size_t index = table_probe(table, key);
+    if (index == table->capacity || !*table_slot(table, index))
+        return NULL;
+    return table_slot(table, index);
+}
+
+int ptr_table_remove(t_ptr_table *table, const void *key)
+{
+    if (!table->capacity)
+        return 0;
+
+    size_t hole = table_probe(table, key);
+    if (hole == table->capacity || !*table_slot(table, hole))
+        return 0;
+
+    size_t mask = table->capacity - 1;
+    size_t next = hole;
+    for (size_t probes = 0; probes < table->capacity; probes++) {
+        next = (next + 1) & mask;
+        void **entry = table_slot(table, next);
+        if (!*entry)
+            break;
+        size_t home = table_home(table, *entry);
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            ft_memcpy(table_slot(table, hole), entry, table->entry_size);
+            hole = next;
+        }
+    }
+
+    *table_slot(table, hole) = NULL;
+    table->count--;
+    return 1;
+}
+
+void *ptr_table_next(const t_ptr_table *table, size_t *cursor)
+{
+    while (*cursor < table->capacity) {
+        void **entry = table_slot(table, (*cursor)++);
+        if (*entry)
+            return entry;
+    }
+    return NULL;
+}
+
+void ptr_table_clear(t_ptr_table *table)
+{
+    if (table->slots)
+        vm_unmap(table->slots, table->capacity * table->entry_size);
+    table->slots = NULL;
+    table->capacity = 0;
+    table->count = 0;
+}
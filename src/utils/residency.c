@@ -0,0 +1,149 @@
+#define _GNU_SOURCE
+#include "../../include/malloc_internal.h"
+#include <sys/mman.h>
+#include <stdint.h>
+
+#define RESIDENCY_WINDOW 256
+
+static const char *g_residency_zone_names[3] = {"TINY", "SMALL", "LARGE"};
+
+static size_t resident_bytes(uintptr_t start, uintptr_t end, size_t page_size)
+{
+    unsigned char vec[RESIDENCY_WINDOW];
+    size_t resident = 0;
+
+    start &= ~(page_size - 1);
+    while (start < end) {
+        size_t pages = (end - start + page_size - 1) / page_size;
+        if (pages > RESIDENCY_WINDOW)
+            pages = RESIDENCY_WINDOW;
+        if (mincore((void *)start, pages * page_size, vec) != 0)
+            return resident;
+        for (size_t i = 0; i < pages; i++)
+            resident += (vec[i] & 1) * page_size;
+        start += pages * page_size;
+    }
+    return resident;
+}
+
+static size_t free_chunk_resident(t_chunk *chunk, size_t page_size)
+{
+    uintptr_t start = (uintptr_t)get_user_ptr(chunk);
+    uintptr_t end = start + chunk->size;
+
+    start = (start + page_size - 1) & ~(page_size - 1);
+    end &= ~(page_size - 1);
+
+    if (end <= start)
+        return 0;
+    return resident_bytes(start, end, page_size);
+}
+
+static void measure_zone(t_zone *zone, t_malloc_zone_residency *res, size_t page_size)
+{
+    t_chunk *chunk = zone_first_chunk(zone);
+    size_t iterations = 0;
+
+    ft_memset(res, 0, sizeof(*res));
+    res->start = (uint64_t)(uintptr_t)zone->start;
+    res->type = zone->type;
+    res->mapped = zone->total_size;
+    res->resident = resident_bytes((uintptr_t)zone->start,
+                                   (uintptr_t)zone->start + zone->total_size, page_size);
+    res->header_bytes = chunk ? (uintptr_t)chunk - (uintptr_t)zone->start : ZONE_HEADER_SIZE;
+
+    while (chunk && iterations < MAX_CHUNKS_PER_ZONE) {
+        res->chunks++;
+        res->header_bytes += CHUNK_HEADER_SIZE;
+        if (chunk->is_free) {
+            res->free_bytes += chunk->size;
+            res->free_resident += free_chunk_resident(chunk, page_size);
+        }
+        chunk = zone_next_chunk(zone, chunk);
+        iterations++;
+    }
+}
+
+static void add_zone(t_malloc_residency *report, const t_malloc_zone_residency *res)
+{
+    report->zones++;
+    report->mapped += res->mapped;
+    report->resident += res->resident;
+    report->free_bytes += res->free_bytes;
+    report->free_resident += res->free_resident;
+    report->header_bytes += res->header_bytes;
+}
+
+int get_malloc_residency(t_malloc_residency *report,
+                         t_malloc_zone_residency *zones, size_t max_zones)
+{
+    t_malloc_zone_residency res;
+    size_t page_size = GET_PAGE_SIZE();
+
+    if (!report || (!zones && max_zones > 0))
+        return -1;
+
+    ft_memset(report, 0, sizeof(*report));
+    malloc_lock(MALLOC_LOCK_MAINTENANCE);
+
+    for (int type = 0; type < 3; type++) {
+        t_zone *zone = g_manager.zones[type];
+        size_t count = 0;
+
+        while (zone && count < zone_list_limit(type)) {
+            measure_zone(zone, &res, page_size);
+            if (report->zones < max_zones)
+                zones[report->zones] = res;
+            add_zone(report, &res);
+            zone = zone->next;
+            count++;
+        }
+    }
+
+    malloc_unlock();
+    return (int)report->zones;
+}
+
+static void print_row(t_out_buffer *out, const t_malloc_residency *res)
+{
+    out_str(out, " mapped=");
+    out_nbr(out, res->mapped);
+    out_str(out, " resident=");
+    out_nbr(out, res->resident);
+    out_str(out, " free=");
+    out_nbr(out, res->free_bytes);
+    out_str(out, " free_resident=");
+    out_nbr(out, res->free_resident);
+    out_str(out, " headers=");
+    out_nbr(out, res->header_bytes);
+    out_char(out, '\n');
+}
+
+void show_malloc_residency(void)
+{
+    t_malloc_zone_residency zones[64];
+    t_malloc_residency report;
+    t_out_buffer out;
+
+    int count = get_malloc_residency(&report, zones, 64);
+    out_init(&out, 1);
+    out_str(&out, "=== Resident Memory ===\n");
+
+    for (int i = 0; i < count && i < 64; i++) {
+        t_malloc_residency row = {1, zones[i].mapped, zones[i].resident, zones[i].free_bytes,
+                                  zones[i].free_resident, zones[i].header_bytes};
+        out_str(&out, g_residency_zone_names[zones[i].type]);
+        out_str(&out, " : 0x");
+        out_hex(&out, zones[i].start);
+        print_row(&out, &row);
+    }
+
+    out_str(&out, "Total:");
+    print_row(&out, &report);
+    if (count > 64) {
+        out_str(&out, "  ... ");
+        out_nbr(&out, count - 64);
+        out_str(&out, " more zones\n");
+    }
+    out_flush(&out);
+}
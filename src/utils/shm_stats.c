@@ -0,0 +1,139 @@
+#define _GNU_SOURCE
+#include "../../include/malloc_internal.h"
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#define SHM_STATS_DIR "/dev/shm/"
+#define SHM_STATS_PATH_MAX 256
+
+static t_malloc_stats_page *g_stats_page = NULL;
+static char g_stats_path[SHM_STATS_PATH_MAX];
+
+static int build_path(const char *name, char *path)
+{
+    size_t prefix = sizeof(SHM_STATS_DIR) - 1;
+    size_t len = 0;
+
+    while (name[len] && len < SHM_STATS_PATH_MAX) {
+        if (name[len] == '/')
+            return -1;
+        len++;
+    }
+    if (len == 0 || name[0] == '.' || prefix + len >= SHM_STATS_PATH_MAX)
+        return -1;
+
+    ft_memcpy(path, SHM_STATS_DIR, prefix);
+    ft_memcpy(path + prefix, name, len);
+    path[prefix + len] = '\0';
+    return 0;
+}
+
+static t_malloc_stats_page *map_page(const char *path)
+{
+    int fd = open(path, O_RDWR | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC, 0644);
+
+    if (fd < 0)
+        return NULL;
+    if (ftruncate(fd, sizeof(t_malloc_stats_page)) != 0) {
+        close(fd);
+        unlink(path);
+        return NULL;
+    }
+
+    void *map = mmap(NULL, sizeof(t_malloc_stats_page), PROT_READ | PROT_WRITE,
+                     MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        stats_record_vm(VM_MMAP, 0);
+        unlink(path);
+        return NULL;
+    }
+    stats_record_vm(VM_MMAP, sizeof(t_malloc_stats_page));
+    return map;
+}
+
+void stats_publish(void)
+{
+    t_malloc_stats_page *page = __atomic_load_n(&g_stats_page, __ATOMIC_RELAXED);
+
+    if (!page)
+        return;
+
+    t_stats_counters *c = &g_manager.stats;
+    uint64_t sequence = page->sequence;
+
+    __atomic_store_n(&page->sequence, sequence + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    page->bytes_allocated = STAT_LOAD(c->bytes_allocated);
+    page->bytes_peak = STAT_LOAD(c->bytes_peak);
+    page->bytes_mapped = STAT_LOAD(c->bytes_mapped);
+    page->zones_active = STAT_LOAD(c->zones_active);
+    for (int type = 0; type < 3; type++)
+        page->zones_by_type[type] = STAT_LOAD(c->zones_by_type[type]);
+    page->mmap_calls = STAT_LOAD(c->vm_calls[VM_MMAP]);
+    page->munmap_calls = STAT_LOAD(c->vm_calls[VM_MUNMAP]);
+    page->reuse_hits = STAT_LOAD(c->reuse_hits);
+    page->reuse_misses = STAT_LOAD(c->reuse_misses);
+    page->errors_count = STAT_LOAD(c->errors_count);
+    __atomic_store_n(&page->sequence, sequence + 2, __ATOMIC_RELEASE);
+}
+
+int malloc_stats_shm_start(const char *name)
+{
+    char path[SHM_STATS_PATH_MAX];
+
+    if (!name || build_path(name, path) != 0)
+        return -1;
+
+    malloc_lock(MALLOC_LOCK_MAINTENANCE);
+    t_malloc_stats_page *page = g_stats_page ? NULL : map_page(path);
+    if (!page) {
+        malloc_unlock();
+        return -1;
+    }
+
+    ft_memcpy(page->magic, MALLOC_STATS_SHM_MAGIC, sizeof(page->magic));
+    page->version = MALLOC_STATS_SHM_VERSION;
+    page->size = sizeof(t_malloc_stats_page);
+    page->pid = (uint64_t)getpid();
+    page->start_time = stats_timestamp();
+    ft_memcpy(g_stats_path, path, sizeof(g_stats_path));
+    __atomic_store_n(&g_stats_page, page, __ATOMIC_RELAXED);
+    stats_publish();
+    malloc_unlock();
+    return 0;
+}
+
+int malloc_stats_shm_stop(void)
+{
+    malloc_lock(MALLOC_LOCK_MAINTENANCE);
+    t_malloc_stats_page *page = g_stats_page;
+    if (!page) {
+        malloc_unlock();
+        return -1;
+    }
+
+    __atomic_store_n(&g_stats_page, NULL, __ATOMIC_RELAXED);
+    unlink(g_stats_path);
+    vm_unmap(page, sizeof(t_malloc_stats_page));
+    malloc_unlock();
+    return 0;
+}
+
+__attribute__((constructor))
+static void stats_shm_from_env(void)
+{
+    const char *name = secure_getenv(MALLOC_STATS_SHM_ENV);
+
+    if (name && name[0])
+        malloc_stats_shm_start(name);
+}
+
+__attribute__((destructor))
+static void stats_shm_stop_at_exit(void)
+{
+    if (g_stats_page)
+        malloc_stats_shm_stop();
+}
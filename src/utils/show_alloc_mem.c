@@ -1,58 +1,286 @@
+#define _GNU_SOURCE
 #include "../../include/malloc_internal.h"
+#include <stdint.h>
 
-static int zone_has_allocations(t_zone *zone)
+static size_t count_zones(size_t *chunk_total)
 {
-    t_chunk *chunk = zone->chunks;
+    size_t count = 0;
+
+    *chunk_total = 0;
+    for (int type = 0; type < 3; type++) {
+        t_zone *zone = g_manager.zones[type];
+        size_t zone_iter = 0;
+
+        while (zone && zone_iter < zone_list_limit(type)) {
+            count++;
+            *chunk_total += zone->chunk_count;
+            zone = zone->next;
+            zone_iter++;
+        }
+    }
+    return count;
+}
+
+static void collect_zones(t_zone **zones, size_t max_zones)
+{
+    size_t count = 0;
+
+    for (int type = 0; type < 3; type++) {
+        t_zone *zone = g_manager.zones[type];
+
+        while (zone && count < max_zones) {
+            zones[count++] = zone;
+            zone = zone->next;
+        }
+    }
+}
+
+static int zone_before(t_zone *a, t_zone *b)
+{
+    return (uintptr_t)a->start < (uintptr_t)b->start;
+}
+
+static void sift_down(t_zone **zones, size_t root, size_t count)
+{
+    while (2 * root + 1 < count) {
+        size_t child = 2 * root + 1;
+
+        if (child + 1 < count && zone_before(zones[child], zones[child + 1]))
+            child++;
+        if (!zone_before(zones[root], zones[child]))
+            return;
+        t_zone *swap = zones[root];
+        zones[root] = zones[child];
+        zones[child] = swap;
+        root = child;
+    }
+}
+
+static void sort_zones(t_zone **zones, size_t count)
+{
+    for (size_t i = count / 2; i > 0; i--)
+        sift_down(zones, i - 1, count);
+    for (size_t end = count; end > 1; end--) {
+        t_zone *swap = zones[0];
+        zones[0] = zones[end - 1];
+        zones[end - 1] = swap;
+        sift_down(zones, 0, end - 1);
+    }
+}
+
+static uintptr_t chunk_site(t_chunk *chunk)
+{
+    uintptr_t site = 0;
+
+    if (chunk->flags & CHUNK_FLAG_SAMPLED)
+        site = prof_sample_site(get_user_ptr(chunk));
+    return site ? site : leak_chunk_site(chunk);
+}
+
+static void push_record(t_heap_snapshot *snap, uintptr_t start, size_t size,
+                        t_zone *zone, t_chunk *chunk)
+{
+    t_heap_entry *record = &snap->records[snap->count++];
+
+    record->start = start;
+    record->size = size;
+    record->type = zone->type;
+    record->kind = chunk ? MALLOC_DUMP_CHUNK : MALLOC_DUMP_ZONE;
+    record->slack = chunk ? chunk->slack : 0;
+    record->flags = chunk ? chunk->flags : 0;
+    record->site = chunk ? chunk_site(chunk) : 0;
+}
+
+static void snapshot_zone(t_heap_snapshot *snap, t_zone *zone)
+{
+    t_chunk *chunk = zone_first_chunk(zone);
+    size_t zone_index = snap->count;
     int chunk_iter = 0;
 
-    while (chunk && chunk_iter < MAX_CHUNKS_PER_ZONE) {
+    push_record(snap, (uintptr_t)zone->start, zone->total_size, zone, NULL);
+
+    while (chunk && chunk_iter < MAX_CHUNKS_PER_ZONE && snap->count < snap->capacity) {
         if (!chunk->is_free)
-            return 1;
-        chunk = chunk->next;
+            push_record(snap, (uintptr_t)get_user_ptr(chunk), chunk->size, zone, chunk);
+        chunk = zone_next_chunk(zone, chunk);
         chunk_iter++;
     }
-    return 0;
+
+    if (snap->count == zone_index + 1)
+        snap->count = zone_index;
 }
 
-static void print_zone_allocations(t_zone *zone, size_t *total)
+int heap_snapshot_take(t_heap_snapshot *snap)
 {
-    t_chunk *chunk = zone->chunks;
-    int chunk_iter = 0;
+    t_zone **zones = NULL;
+    size_t chunk_total;
 
-    while (chunk && chunk_iter < MAX_CHUNKS_PER_ZONE) {
-        if (!chunk->is_free) {
-            void *user_ptr = get_user_ptr(chunk);
-            void *end_ptr = (char *)user_ptr + chunk->size;
-            print_allocation(user_ptr, end_ptr, chunk->size);
-            *total += chunk->size;
-        }
-        chunk = chunk->next;
-        chunk_iter++;
+    snap->records = NULL;
+    snap->count = 0;
+
+    malloc_lock(MALLOC_LOCK_MAINTENANCE);
+
+    size_t zone_count = count_zones(&chunk_total);
+    snap->capacity = zone_count + chunk_total;
+    if (zone_count > 0)
+        zones = vm_map(zone_count * sizeof(t_zone *));
+    if (zones)
+        snap->records = vm_map(snap->capacity * sizeof(t_heap_entry));
+
+    if (snap->records) {
+        collect_zones(zones, zone_count);
+        sort_zones(zones, zone_count);
+        for (size_t i = 0; i < zone_count; i++)
+            snapshot_zone(snap, zones[i]);
     }
+
+    malloc_unlock();
+
+    if (zones)
+        vm_unmap(zones, zone_count * sizeof(t_zone *));
+    return snap->capacity == 0 || snap->records ? 0 : -1;
 }
 
-void show_alloc_mem(void)
+void heap_snapshot_release(t_heap_snapshot *snap)
 {
-    pthread_mutex_lock(&g_mutex);
+    if (snap->records)
+        vm_unmap(snap->records, snap->capacity * sizeof(t_heap_entry));
+    snap->records = NULL;
+    snap->count = 0;
+    snap->capacity = 0;
+}
 
+static size_t snapshot_total(const t_heap_snapshot *snap)
+{
     size_t total = 0;
-    const char *zone_names[] = {"TINY", "SMALL", "LARGE"};
 
-    for (int type = 0; type < 3; type++) {
-        t_zone *zone = g_manager.zones[type];
-        int zone_iter = 0;
+    for (size_t i = 0; i < snap->count; i++) {
+        if (snap->records[i].kind == MALLOC_DUMP_CHUNK)
+            total += snap->records[i].size;
+    }
+    return total;
+}
 
-        while (zone && zone_iter < MAX_ZONES_PER_TYPE) {
-            if (zone_has_allocations(zone)) {
-                print_zone_header(zone_names[type], zone->start);
-                print_zone_allocations(zone, &total);
-            }
-            zone = zone->next;
-            zone_iter++;
+static void write_text(t_out_buffer *out, const t_heap_snapshot *snap)
+{
+    static const char *zone_names[] = {"TINY", "SMALL", "LARGE"};
+
+    for (size_t i = 0; i < snap->count; i++) {
+        const t_heap_entry *record = &snap->records[i];
+
+        if (record->kind == MALLOC_DUMP_ZONE) {
+            out_str(out, zone_names[record->type]);
+            out_str(out, " : 0x");
+            out_hex(out, record->start);
+        } else {
+            out_str(out, "0x");
+            out_hex(out, record->start);
+            out_str(out, " - 0x");
+            out_hex(out, record->start + record->size);
+            out_str(out, " : ");
+            out_nbr(out, record->size);
+            out_str(out, " bytes");
         }
+        out_char(out, '\n');
+    }
+
+    out_str(out, "Total : ");
+    out_nbr(out, snapshot_total(snap));
+    out_str(out, " bytes\n");
+}
+
+static void write_json_record(t_out_buffer *out, const t_heap_entry *record)
+{
+    static const char *zone_names[] = {"TINY", "SMALL", "LARGE"};
+
+    if (record->kind == MALLOC_DUMP_ZONE) {
+        out_str(out, "{\"type\":\"");
+        out_str(out, zone_names[record->type]);
+        out_str(out, "\",\"start\":\"0x");
+        out_hex(out, record->start);
+        out_str(out, "\",\"size\":");
+        out_nbr(out, record->size);
+        out_str(out, ",\"chunks\":[");
+        return;
     }
 
-    print_total(total);
+    out_str(out, "{\"start\":\"0x");
+    out_hex(out, record->start);
+    out_str(out, "\",\"size\":");
+    out_nbr(out, record->size);
+    out_char(out, '}');
+}
 
-    pthread_mutex_unlock(&g_mutex);
+static void write_json(t_out_buffer *out, const t_heap_snapshot *snap)
+{
+    out_str(out, "{\"zones\":[");
+
+    for (size_t i = 0; i < snap->count; i++) {
+        const t_heap_entry *record = &snap->records[i];
+
+        if (record->kind == MALLOC_DUMP_ZONE && i > 0)
+            out_str(out, "]},");
+        else if (record->kind == MALLOC_DUMP_CHUNK &&
+                 snap->records[i - 1].kind == MALLOC_DUMP_CHUNK)
+            out_char(out, ',');
+        write_json_record(out, record);
+    }
+
+    if (snap->count > 0)
+        out_str(out, "]}");
+    out_str(out, "],\"total\":");
+    out_nbr(out, snapshot_total(snap));
+    out_str(out, "}\n");
+}
+
+static void write_binary(t_out_buffer *out, const t_heap_snapshot *snap)
+{
+    t_malloc_dump_header header;
+
+    ft_memset(&header, 0, sizeof(header));
+    ft_memcpy(header.magic, MALLOC_DUMP_MAGIC, sizeof(header.magic));
+    header.version = MALLOC_DUMP_VERSION;
+    header.record_size = sizeof(t_malloc_dump_record);
+    header.record_count = snap->count;
+    header.total = snapshot_total(snap);
+
+    out_bytes(out, &header, sizeof(header));
+    for (size_t i = 0; i < snap->count; i++) {
+        t_malloc_dump_record record;
+
+        record.start = snap->records[i].start;
+        record.size = snap->records[i].size;
+        record.type = snap->records[i].type;
+        record.kind = snap->records[i].kind;
+        out_bytes(out, &record, sizeof(record));
+    }
+}
+
+int show_alloc_mem_fd(int fd, t_malloc_dump_format format)
+{
+    t_heap_snapshot snap;
+    t_out_buffer out;
+
+    if (fd < 0 || format < MALLOC_DUMP_TEXT || format > MALLOC_DUMP_BINARY)
+        return -1;
+
+    if (heap_snapshot_take(&snap) != 0)
+        return -1;
+
+    out_init(&out, fd);
+    if (format == MALLOC_DUMP_TEXT)
+        write_text(&out, &snap);
+    else if (format == MALLOC_DUMP_JSON)
+        write_json(&out, &snap);
+    else
+        write_binary(&out, &snap);
+    out_flush(&out);
+
+    heap_snapshot_release(&snap);
+    return 0;
+}
+
+void show_alloc_mem(void)
+{
+    show_alloc_mem_fd(1, MALLOC_DUMP_TEXT);
 }
@@ -0,0 +1,63 @@
+#define _GNU_SOURCE
+#include "../../include/malloc_internal.h"
+#include <time.h>
+
+static void write_heap_header(t_out_buffer *out, const t_heap_snapshot *snap)
+{
+    t_malloc_heap_header header;
+    struct timespec ts;
+
+    ft_memset(&header, 0, sizeof(header));
+    ft_memcpy(header.magic, MALLOC_HEAP_MAGIC, sizeof(header.magic));
+    header.version = MALLOC_HEAP_VERSION;
+    header.record_size = sizeof(t_malloc_heap_record);
+
+    for (size_t i = 0; i < snap->count; i++) {
+        const t_heap_entry *entry = &snap->records[i];
+        if (entry->kind == MALLOC_DUMP_CHUNK) {
+            header.record_count++;
+            header.live_bytes += entry->size - entry->slack;
+        }
+    }
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+    header.timestamp = (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+    for (size_t i = 0; i < MALLOC_SIZE_CLASSES; i++)
+        header.class_max[i] = size_class_max(i);
+
+    out_bytes(out, &header, sizeof(header));
+}
+
+static void write_heap_record(t_out_buffer *out, const t_heap_entry *entry)
+{
+    t_malloc_heap_record record;
+
+    record.address = entry->start;
+    record.size = entry->size - entry->slack;
+    record.site = entry->site;
+    record.type = (uint16_t)entry->type;
+    record.size_class = (uint16_t)size_class_index(record.size);
+    record.slack = entry->slack;
+
+    out_bytes(out, &record, sizeof(record));
+}
+
+int heap_snapshot(int fd)
+{
+    t_heap_snapshot snap;
+    t_out_buffer out;
+
+    if (fd < 0 || heap_snapshot_take(&snap) != 0)
+        return -1;
+
+    out_init(&out, fd);
+    write_heap_header(&out, &snap);
+    for (size_t i = 0; i < snap.count; i++) {
+        if (snap.records[i].kind == MALLOC_DUMP_CHUNK)
+            write_heap_record(&out, &snap.records[i]);
+    }
+    out_flush(&out);
+
+    heap_snapshot_release(&snap);
+    return 0;
+}
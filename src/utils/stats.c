@@ -1,57 +1,257 @@
+#define _GNU_SOURCE
 #include "../../include/malloc_internal.h"
+#include <sys/resource.h>
+#include <time.h>
 
 int malloc_validate_system(void)
 {
     return 0;
 }
 
+size_t size_class_index(size_t size)
+{
+    if (size <= TINY_MAX)
+        return size ? (ALIGN(size) / SIZE_CLASS_TINY_STEP) - 1 : 0;
+
+    if (size <= SMALL_MAX)
+        return SIZE_CLASS_TINY_COUNT + (size - TINY_MAX - 1) / SIZE_CLASS_SMALL_STEP;
+
+    size_t index = SIZE_CLASS_TINY_COUNT + SIZE_CLASS_SMALL_COUNT;
+    size_t bound = (size_t)SMALL_MAX * 2;
+
+    while (size > bound && index < MALLOC_SIZE_CLASSES - 1) {
+        bound <<= 1;
+        index++;
+    }
+    return index;
+}
+
+size_t size_class_max(size_t index)
+{
+    if (index < SIZE_CLASS_TINY_COUNT)
+        return (index + 1) * SIZE_CLASS_TINY_STEP;
+
+    if (index < SIZE_CLASS_TINY_COUNT + SIZE_CLASS_SMALL_COUNT)
+        return TINY_MAX + (index - SIZE_CLASS_TINY_COUNT + 1) * SIZE_CLASS_SMALL_STEP;
+
+    if (index >= MALLOC_SIZE_CLASSES - 1)
+        return (size_t)-1;
+
+    return (size_t)SMALL_MAX << (index - SIZE_CLASS_TINY_COUNT - SIZE_CLASS_SMALL_COUNT + 1);
+}
+
+static void class_add(size_t requested, uint32_t slack)
+{
+    t_stats_counters *c = &g_manager.stats;
+    size_t index = size_class_index(requested);
+
+    STAT_ADD(c->class_count[index], 1);
+    STAT_ADD(c->class_bytes[index], requested);
+    STAT_ADD(c->class_wasted[index], slack + CHUNK_HEADER_SIZE);
+}
+
+static void class_remove(size_t requested, uint32_t slack)
+{
+    t_stats_counters *c = &g_manager.stats;
+    size_t index = size_class_index(requested);
+
+    STAT_SUB(c->class_count[index], 1);
+    STAT_SUB(c->class_bytes[index], requested);
+    STAT_SUB(c->class_wasted[index], slack + CHUNK_HEADER_SIZE);
+}
+
+void stats_record_alloc(t_chunk *chunk)
+{
+    t_stats_counters *c = &g_manager.stats;
+    size_t allocated = STAT_LOAD(c->bytes_allocated) + chunk->size;
+    size_t requested = chunk->size - chunk->slack;
+
+    STAT_ADD(c->allocs[chunk->zone->type], 1);
+    STAT_ADD(c->bytes_total, chunk->size);
+    __atomic_store_n(&c->bytes_allocated, allocated, __ATOMIC_RELAXED);
+    if (allocated > STAT_LOAD(c->bytes_peak))
+        __atomic_store_n(&c->bytes_peak, allocated, __ATOMIC_RELAXED);
+
+    STAT_ADD(c->class_allocs[size_class_index(requested)], 1);
+    class_add(requested, chunk->slack);
+    thread_stats_alloc(chunk);
+    stats_publish();
+}
+
+void stats_record_free(t_chunk *chunk)
+{
+    t_stats_counters *c = &g_manager.stats;
+    size_t requested = chunk->size - chunk->slack;
+
+    STAT_SUB(c->allocs[chunk->zone->type], 1);
+    STAT_SUB(c->bytes_allocated, chunk->size);
+
+    STAT_ADD(c->class_frees[size_class_index(requested)], 1);
+    class_remove(requested, chunk->slack);
+    thread_stats_free(chunk);
+    stats_publish();
+}
+
+void stats_record_resize(t_chunk *chunk, size_t old_size, uint32_t old_slack)
+{
+    STAT_SUB(g_manager.stats.bytes_allocated, old_size - chunk->size);
+    class_remove(old_size - old_slack, old_slack);
+    class_add(chunk->size - chunk->slack, chunk->slack);
+    thread_stats_resize(chunk, old_size - chunk->size);
+    stats_publish();
+}
+
+void stats_record_zone_map(t_zone *zone)
+{
+    t_stats_counters *c = &g_manager.stats;
+
+    STAT_ADD(c->zones_active, 1);
+    STAT_ADD(c->zones_total, 1);
+    STAT_ADD(c->zones_by_type[zone->type], 1);
+    STAT_ADD(c->bytes_mapped, zone->total_size);
+    latency_note_mmap();
+    hook_note_zone(zone, 1);
+    stats_publish();
+}
+
+void stats_record_zone_unmap(t_zone *zone)
+{
+    t_stats_counters *c = &g_manager.stats;
+
+    STAT_SUB(c->zones_active, 1);
+    STAT_SUB(c->zones_by_type[zone->type], 1);
+    STAT_SUB(c->bytes_mapped, zone->total_size);
+    latency_note_munmap();
+    hook_note_zone(zone, 0);
+    stats_publish();
+}
+
+void stats_record_error(int corruption)
+{
+    if (corruption)
+        STAT_ATOMIC_ADD(g_manager.stats.corruption_count, 1);
+    else
+        STAT_ATOMIC_ADD(g_manager.stats.errors_count, 1);
+}
+
+void stats_record_vm(t_vm_op op, size_t bytes)
+{
+    STAT_ATOMIC_ADD(g_manager.stats.vm_calls[op], 1);
+    STAT_ATOMIC_ADD(g_manager.stats.vm_bytes[op], bytes);
+}
+
+static void stats_fill_vm(t_malloc_stats *stats)
+{
+    t_stats_counters *c = &g_manager.stats;
+    struct rusage usage;
+
+    stats->mmap_calls = STAT_LOAD(c->vm_calls[VM_MMAP]);
+    stats->mmap_bytes = STAT_LOAD(c->vm_bytes[VM_MMAP]);
+    stats->munmap_calls = STAT_LOAD(c->vm_calls[VM_MUNMAP]);
+    stats->munmap_bytes = STAT_LOAD(c->vm_bytes[VM_MUNMAP]);
+    stats->madvise_calls = STAT_LOAD(c->vm_calls[VM_MADVISE]);
+    stats->madvise_bytes = STAT_LOAD(c->vm_bytes[VM_MADVISE]);
+    stats->mremap_calls = STAT_LOAD(c->vm_calls[VM_MREMAP]);
+    stats->mremap_bytes = STAT_LOAD(c->vm_bytes[VM_MREMAP]);
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        stats->minor_faults = (size_t)usage.ru_minflt;
+        stats->major_faults = (size_t)usage.ru_majflt;
+    }
+}
+
+void stats_reset_live(void)
+{
+    t_stats_counters *c = &g_manager.stats;
+
+    __atomic_store_n(&c->bytes_allocated, 0, __ATOMIC_RELAXED);
+    for (int type = 0; type < 3; type++)
+        __atomic_store_n(&c->allocs[type], 0, __ATOMIC_RELAXED);
+    for (int index = 0; index < MALLOC_SIZE_CLASSES; index++) {
+        __atomic_store_n(&c->class_count[index], 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&c->class_bytes[index], 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&c->class_wasted[index], 0, __ATOMIC_RELAXED);
+    }
+    thread_stats_reset_live();
+    stats_publish();
+}
+
+uint64_t stats_timestamp(void)
+{
+    struct timespec ts;
+
+    if (clock_gettime(CLOCK_REALTIME, &ts) != 0)
+        return 0;
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
 int get_malloc_stats(t_malloc_stats *stats)
 {
     if (!stats)
         return -1;
 
+    t_stats_counters *c = &g_manager.stats;
+
     ft_memset(stats, 0, sizeof(t_malloc_stats));
+    stats->bytes_allocated = STAT_LOAD(c->bytes_allocated);
+    stats->bytes_peak = STAT_LOAD(c->bytes_peak);
+    stats->bytes_total = STAT_LOAD(c->bytes_total);
+    stats->allocs_tiny = STAT_LOAD(c->allocs[ZONE_TINY]);
+    stats->allocs_small = STAT_LOAD(c->allocs[ZONE_SMALL]);
+    stats->allocs_large = STAT_LOAD(c->allocs[ZONE_LARGE]);
+    stats->zones_active = STAT_LOAD(c->zones_active);
+    stats->zones_total = STAT_LOAD(c->zones_total);
+    stats->errors_count = STAT_LOAD(c->errors_count);
+    stats->corruption_count = STAT_LOAD(c->corruption_count);
+    stats->pools_active = STAT_LOAD(c->pools_active);
+    stats->pool_slabs = STAT_LOAD(c->pool_slabs);
+    stats->pool_objects_in_use = STAT_LOAD(c->pool_objects_in_use);
+    stats->pool_bytes_mapped = STAT_LOAD(c->pool_bytes_mapped);
+    for (int type = 0; type < 3; type++)
+        stats->zones_by_type[type] = STAT_LOAD(c->zones_by_type[type]);
+    stats->reuse_hits = STAT_LOAD(c->reuse_hits);
+    stats->reuse_misses = STAT_LOAD(c->reuse_misses);
+    stats->hook_events_dropped = STAT_LOAD(c->hook_events_dropped);
 
-    pthread_mutex_lock(&g_mutex);
+    size_t mapped = STAT_LOAD(c->bytes_mapped);
+    stats->bytes_mapped = mapped;
+    if (mapped > 0 && stats->bytes_allocated <= mapped)
+        stats->fragmentation = 1.0 - (double)stats->bytes_allocated / (double)mapped;
 
-    for (int type = 0; type < 3; type++) {
-        t_zone *zone = g_manager.zones[type];
-        int zone_iter = 0;
-        while (zone && zone_iter < MAX_ZONES_PER_TYPE) {
-            t_chunk *chunk = zone->chunks;
-            int chunk_iter = 0;
-            while (chunk && chunk_iter < MAX_CHUNKS_PER_ZONE) {
-                if (!chunk->is_free) {
-                    stats->bytes_allocated += chunk->size;
-                    if (type == ZONE_TINY)
-                        stats->allocs_tiny++;
-                    else if (type == ZONE_SMALL)
-                        stats->allocs_small++;
-                    else
-                        stats->allocs_large++;
-                }
-                chunk = chunk->next;
-                chunk_iter++;
-            }
-            zone = zone->next;
-            zone_iter++;
-        }
+    stats_fill_vm(stats);
+    stats->update_time = stats_timestamp();
+    return 0;
+}
+
+int get_malloc_size_classes(t_malloc_size_class *classes, size_t max_classes)
+{
+    if (!classes)
+        return -1;
+
+    t_stats_counters *c = &g_manager.stats;
+    size_t count = max_classes < MALLOC_SIZE_CLASSES ? max_classes : MALLOC_SIZE_CLASSES;
+
+    for (size_t i = 0; i < count; i++) {
+        classes[i].size_max = size_class_max(i);
+        classes[i].count = STAT_LOAD(c->class_count[i]);
+        classes[i].allocs = STAT_LOAD(c->class_allocs[i]);
+        classes[i].frees = STAT_LOAD(c->class_frees[i]);
+        classes[i].bytes_in_use = STAT_LOAD(c->class_bytes[i]);
+        classes[i].bytes_wasted = STAT_LOAD(c->class_wasted[i]);
     }
 
-    pthread_mutex_unlock(&g_mutex);
-    return 0;
+    return (int)count;
 }
 
 int check_malloc_leaks(void)
 {
     int leaks = 0;
 
-    pthread_mutex_lock(&g_mutex);
+    malloc_lock(MALLOC_LOCK_MAINTENANCE);
 
     for (int type = 0; type < 3; type++) {
         t_zone *zone = g_manager.zones[type];
-        int zone_iter = 0;
-        while (zone && zone_iter < MAX_ZONES_PER_TYPE) {
+        size_t zone_iter = 0;
+        while (zone && zone_iter < zone_list_limit(type)) {
             t_chunk *chunk = zone->chunks;
             int chunk_iter = 0;
             while (chunk && chunk_iter < MAX_CHUNKS_PER_ZONE) {
@@ -65,6 +265,6 @@ int check_malloc_leaks(void)
         }
     }
 
-    pthread_mutex_unlock(&g_mutex);
+    malloc_unlock();
     return leaks;
 }
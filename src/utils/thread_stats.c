@@ -0,0 +1,225 @@
+#define _GNU_SOURCE
+#include "../../include/malloc_internal.h"
+#include <sys/syscall.h>
+#include <unistd.h>
+
+static t_malloc_thread_stats *g_threads = NULL;
+static uint32_t g_thread_count = 1;
+static uint8_t g_thread_retired[THREAD_STATS_MAX];
+static uint32_t g_thread_retired_count = 0;
+static pthread_key_t g_thread_key;
+static pthread_once_t g_thread_key_once = PTHREAD_ONCE_INIT;
+static __thread t_malloc_thread_stats *g_thread_self = NULL;
+static __thread int g_thread_key_pending = 0;
+
+static uint64_t thread_id(void)
+{
+#ifdef SYS_gettid
+    return (uint64_t)syscall(SYS_gettid);
+#else
+    return (uint64_t)(uintptr_t)pthread_self();
+#endif
+}
+
+static int thread_alive(uint64_t id)
+{
+#ifdef SYS_tgkill
+    return syscall(SYS_tgkill, getpid(), (pid_t)id, 0) == 0;
+#else
+    (void)id;
+    return 1;
+#endif
+}
+
+static void thread_stats_destructor(void *value)
+{
+    t_malloc_thread_stats *entry = value;
+
+    malloc_lock(MALLOC_LOCK_MAINTENANCE);
+    if (entry == g_thread_self && !g_thread_retired[entry->index]) {
+        g_thread_retired[entry->index] = 1;
+        g_thread_retired_count++;
+    }
+    g_thread_self = NULL;
+    malloc_unlock();
+}
+
+static void thread_key_init(void)
+{
+    pthread_key_create(&g_thread_key, thread_stats_destructor);
+}
+
+void thread_stats_attach(void)
+{
+    if (__builtin_expect(!g_thread_key_pending, 1))
+        return;
+
+    g_thread_key_pending = 0;
+    pthread_once(&g_thread_key_once, thread_key_init);
+    pthread_setspecific(g_thread_key, g_thread_self);
+}
+
+static uint32_t claim_slot(void)
+{
+    for (uint32_t i = 1; g_thread_retired_count > 0 && i < g_thread_count; i++) {
+        if (g_thread_retired[i] && g_threads[i].bytes_in_flight == 0) {
+            g_thread_retired[i] = 0;
+            g_thread_retired_count--;
+            ft_memset(&g_threads[i], 0, sizeof(g_threads[i]));
+            return i;
+        }
+    }
+    return g_thread_count < THREAD_STATS_MAX ? g_thread_count++ : 0;
+}
+
+static t_malloc_thread_stats *thread_self(void)
+{
+    if (g_thread_self)
+        return g_thread_self;
+
+    if (!g_threads) {
+        void *map = vm_map(THREAD_STATS_MAX * sizeof(t_malloc_thread_stats));
+        if (!map)
+            return NULL;
+        g_threads = map;
+    }
+
+    uint32_t slot = claim_slot();
+    t_malloc_thread_stats *entry = &g_threads[slot];
+    if (slot != 0) {
+        entry->thread_id = thread_id();
+        entry->index = slot;
+        g_thread_key_pending = 1;
+    }
+    g_thread_self = entry;
+    return entry;
+}
+
+static t_malloc_thread_stats *chunk_owner(t_chunk *chunk)
+{
+    uint32_t slot = chunk->flags >> CHUNK_OWNER_SHIFT;
+
+    if (!g_threads || slot >= g_thread_count)
+        return NULL;
+    return &g_threads[slot];
+}
+
+static void release_bytes(t_malloc_thread_stats *owner, size_t bytes)
+{
+    if (owner)
+        owner->bytes_in_flight -= owner->bytes_in_flight < bytes ? owner->bytes_in_flight : bytes;
+}
+
+void thread_stats_alloc(t_chunk *chunk)
+{
+    t_malloc_thread_stats *self = thread_self();
+
+    if (!self)
+        return;
+
+    self->allocs++;
+    self->bytes_allocated += chunk->size;
+    self->bytes_in_flight += chunk->size;
+    chunk->flags = (chunk->flags & ((1U << CHUNK_OWNER_SHIFT) - 1)) |
+                   (self->index << CHUNK_OWNER_SHIFT);
+}
+
+void thread_stats_free(t_chunk *chunk)
+{
+    t_malloc_thread_stats *self = thread_self();
+    t_malloc_thread_stats *owner = chunk_owner(chunk);
+
+    release_bytes(owner, chunk->size);
+    if (!self)
+        return;
+
+    self->frees++;
+    if (owner != self)
+        self->remote_frees++;
+}
+
+void thread_stats_resize(t_chunk *chunk, size_t released)
+{
+    release_bytes(chunk_owner(chunk), released);
+}
+
+void thread_stats_reset_live(void)
+{
+    for (uint32_t i = 0; g_threads && i < g_thread_count; i++)
+        g_threads[i].bytes_in_flight = 0;
+}
+
+static void select_top(t_malloc_thread_stats *threads, size_t count, char *taken)
+{
+    for (size_t n = 0; n < count; n++) {
+        uint32_t best = 0;
+        int found = 0;
+
+        for (uint32_t i = 0; i < g_thread_count; i++) {
+            if (taken[i] || (i == 0 && g_threads[0].allocs == 0))
+                continue;
+            if (!found || g_threads[i].bytes_in_flight > g_threads[best].bytes_in_flight) {
+                best = i;
+                found = 1;
+            }
+        }
+        taken[best] = 1;
+        threads[n] = g_threads[best];
+    }
+}
+
+int get_malloc_thread_stats(t_malloc_thread_stats *threads, size_t max_threads)
+{
+    char taken[THREAD_STATS_MAX];
+
+    if (!threads && max_threads > 0)
+        return -1;
+
+    malloc_lock(MALLOC_LOCK_MAINTENANCE);
+    size_t available = g_threads ? g_thread_count - (g_threads[0].allocs == 0) : 0;
+    size_t count = max_threads < available ? max_threads : available;
+
+    ft_memset(taken, 0, sizeof(taken));
+    if (count > 0)
+        select_top(threads, count, taken);
+    malloc_unlock();
+
+    for (size_t i = 0; i < count; i++)
+        threads[i].alive = threads[i].index != 0 && thread_alive(threads[i].thread_id);
+    return (int)count;
+}
+
+static void print_thread(t_out_buffer *out, const t_malloc_thread_stats *thread)
+{
+    if (thread->index == 0) {
+        out_str(out, "(untracked)");
+    } else {
+        out_str(out, "tid ");
+        out_nbr(out, thread->thread_id);
+        out_str(out, thread->alive ? "" : " (exited)");
+    }
+    out_str(out, ": in_flight=");
+    out_nbr(out, thread->bytes_in_flight);
+    out_str(out, " allocated=");
+    out_nbr(out, thread->bytes_allocated);
+    out_str(out, " allocs=");
+    out_nbr(out, thread->allocs);
+    out_str(out, " frees=");
+    out_nbr(out, thread->frees);
+    out_str(out, " remote_frees=");
+    out_nbr(out, thread->remote_frees);
+    out_char(out, '\n');
+}
+
+void show_malloc_thread_stats(size_t top)
+{
+    t_malloc_thread_stats threads[64];
+    t_out_buffer out;
+
+    int count = get_malloc_thread_stats(threads, top < 64 ? top : 64);
+    out_init(&out, 1);
+    out_str(&out, "=== Top Threads by Bytes in Flight ===\n");
+    for (int i = 0; i < count; i++)
+        print_thread(&out, &threads[i]);
+    out_flush(&out);
+}
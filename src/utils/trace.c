@@ -0,0 +1,206 @@
+#define _GNU_SOURCE
+#include "../../include/malloc_internal.h"
+#include <fcntl.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+typedef struct s_trace_buffer {
+    struct s_trace_buffer *next;
+    uint32_t thread;
+    size_t count;
+    size_t flushed;
+    t_malloc_trace_record records[TRACE_BUFFER_RECORDS];
+} t_trace_buffer;
+
+static pthread_mutex_t g_trace_lock = PTHREAD_MUTEX_INITIALIZER;
+static t_trace_buffer *g_trace_buffers = NULL;
+static uint32_t g_trace_next_thread = 0;
+static int g_trace_fd = -1;
+static int g_trace_enabled = 0;
+static pthread_key_t g_trace_key;
+static pthread_once_t g_trace_once = PTHREAD_ONCE_INIT;
+static __thread t_trace_buffer *g_trace_buffer = NULL;
+static __thread int g_trace_depth = 0;
+
+static uint64_t trace_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void trace_write_pending(t_trace_buffer *buffer)
+{
+    size_t count = __atomic_load_n(&buffer->count, __ATOMIC_ACQUIRE);
+    size_t done = buffer->flushed * sizeof(t_malloc_trace_record);
+    size_t end = count * sizeof(t_malloc_trace_record);
+    int retries = 0;
+
+    while (g_trace_fd >= 0 && done < end && retries < 100) {
+        ssize_t written = write(g_trace_fd, (char *)buffer->records + done, end - done);
+        if (written <= 0)
+            retries++;
+        else
+            done += (size_t)written;
+    }
+    buffer->flushed = count;
+}
+
+static void trace_thread_exit(void *value)
+{
+    t_trace_buffer *buffer = value;
+    t_trace_buffer **link = &g_trace_buffers;
+
+    lock_acquire(&g_trace_lock, MALLOC_LOCK_TRACE);
+    trace_write_pending(buffer);
+    while (*link && *link != buffer)
+        link = &(*link)->next;
+    if (*link)
+        *link = buffer->next;
+    pthread_mutex_unlock(&g_trace_lock);
+
+    g_trace_buffer = NULL;
+    vm_unmap(buffer, sizeof(t_trace_buffer));
+}
+
+static void trace_key_init(void)
+{
+    pthread_key_create(&g_trace_key, trace_thread_exit);
+}
+
+static t_trace_buffer *trace_buffer(void)
+{
+    if (g_trace_buffer)
+        return g_trace_buffer;
+
+    void *map = vm_map(sizeof(t_trace_buffer));
+    if (!map)
+        return NULL;
+
+    t_trace_buffer *buffer = map;
+    pthread_once(&g_trace_once, trace_key_init);
+
+    lock_acquire(&g_trace_lock, MALLOC_LOCK_TRACE);
+    buffer->thread = g_trace_next_thread++;
+    buffer->next = g_trace_buffers;
+    g_trace_buffers = buffer;
+    pthread_mutex_unlock(&g_trace_lock);
+
+    pthread_setspecific(g_trace_key, buffer);
+    g_trace_buffer = buffer;
+    return buffer;
+}
+
+uint64_t trace_begin(void)
+{
+    if (!__atomic_load_n(&g_trace_enabled, __ATOMIC_RELAXED))
+        return TRACE_OFF;
+
+    if (g_trace_depth++ > 0)
+        return TRACE_NESTED;
+
+    uint64_t now = trace_now();
+    return now > TRACE_NESTED ? now : TRACE_NESTED + 1;
+}
+
+void trace_end(uint64_t start, t_malloc_op op, void *ptr, void *old_ptr, size_t size)
+{
+    if (start == TRACE_OFF)
+        return;
+
+    g_trace_depth--;
+    if (start == TRACE_NESTED)
+        return;
+
+    t_trace_buffer *buffer = trace_buffer();
+    if (!buffer)
+        return;
+
+    size_t count = buffer->count;
+    if (count == TRACE_BUFFER_RECORDS) {
+        lock_acquire(&g_trace_lock, MALLOC_LOCK_TRACE);
+        trace_write_pending(buffer);
+        buffer->flushed = 0;
+        __atomic_store_n(&buffer->count, 0, __ATOMIC_RELEASE);
+        pthread_mutex_unlock(&g_trace_lock);
+        count = 0;
+    }
+
+    t_malloc_trace_record *record = &buffer->records[count];
+    record->timestamp = op == MALLOC_OP_FREE ? start : trace_now();
+    record->ptr = (uint64_t)(uintptr_t)ptr;
+    record->old_ptr = (uint64_t)(uintptr_t)old_ptr;
+    record->size = size;
+    record->thread = buffer->thread;
+    record->op = op;
+    __atomic_store_n(&buffer->count, count + 1, __ATOMIC_RELEASE);
+}
+
+int malloc_trace_start(const char *path)
+{
+    t_malloc_trace_header header;
+
+    if (!path)
+        return -1;
+
+    lock_acquire(&g_trace_lock, MALLOC_LOCK_TRACE);
+    int fd = g_trace_fd < 0 ? open(path, O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW | O_APPEND | O_CLOEXEC, 0644) : -1;
+    if (fd < 0) {
+        pthread_mutex_unlock(&g_trace_lock);
+        return -1;
+    }
+
+    ft_memset(&header, 0, sizeof(header));
+    ft_memcpy(header.magic, MALLOC_TRACE_MAGIC, sizeof(header.magic));
+    header.version = MALLOC_TRACE_VERSION;
+    header.record_size = sizeof(t_malloc_trace_record);
+    if (write(fd, &header, sizeof(header)) != (ssize_t)sizeof(header)) {
+        close(fd);
+        pthread_mutex_unlock(&g_trace_lock);
+        return -1;
+    }
+
+    for (t_trace_buffer *buffer = g_trace_buffers; buffer; buffer = buffer->next)
+        buffer->flushed = __atomic_load_n(&buffer->count, __ATOMIC_ACQUIRE);
+
+    g_trace_fd = fd;
+    __atomic_store_n(&g_trace_enabled, 1, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&g_trace_lock);
+    return 0;
+}
+
+int malloc_trace_stop(void)
+{
+    lock_acquire(&g_trace_lock, MALLOC_LOCK_TRACE);
+    if (g_trace_fd < 0) {
+        pthread_mutex_unlock(&g_trace_lock);
+        return -1;
+    }
+
+    __atomic_store_n(&g_trace_enabled, 0, __ATOMIC_RELEASE);
+    for (t_trace_buffer *buffer = g_trace_buffers; buffer; buffer = buffer->next)
+        trace_write_pending(buffer);
+
+    close(g_trace_fd);
+    g_trace_fd = -1;
+    pthread_mutex_unlock(&g_trace_lock);
+    return 0;
+}
+
+__attribute__((constructor))
+static void trace_start_from_env(void)
+{
+    const char *path = secure_getenv(MALLOC_TRACE_ENV);
+
+    if (path && path[0])
+        malloc_trace_start(path);
+}
+
+__attribute__((destructor))
+static void trace_stop_at_exit(void)
+{
+    if (g_trace_fd >= 0)
+        malloc_trace_stop();
+}
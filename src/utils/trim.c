@@ -0,0 +1,101 @@
+#define _GNU_SOURCE
+#include "../../include/malloc_internal.h"
+#include <stdint.h>
+
+static size_t purge_free_chunk(t_chunk *chunk, size_t page_size)
+{
+	uintptr_t start = (uintptr_t)get_user_ptr(chunk);
+	uintptr_t end = start + chunk->size;
+
+	start = (start + page_size - 1) & ~(page_size - 1);
+	end &= ~(page_size - 1);
+
+	if (end <= start)
+		return 0;
+
+	if (vm_purge((void *)start, end - start) != 0)
+		return 0;
+
+	chunk->flags |= CHUNK_FLAG_PURGED;
+	return end - start;
+}
+
+static size_t purge_zone(t_zone *zone)
+{
+	size_t page_size = GET_PAGE_SIZE();
+	size_t purged = 0;
+	t_chunk *chunk = zone->chunks;
+	int chunk_iter = 0;
+
+	while (chunk && chunk_iter < MAX_CHUNKS_PER_ZONE) {
+		if (chunk->is_free && !(chunk->flags & CHUNK_FLAG_PURGED))
+			purged += purge_free_chunk(chunk, page_size);
+		chunk = chunk->next;
+		chunk_iter++;
+	}
+
+	return purged;
+}
+
+static void trim_zones_of_type(t_zone_type type, size_t *retained,
+	size_t pad, t_malloc_trim_report *report)
+{
+	t_zone *zone = g_manager.zones[type];
+	t_zone *prev = NULL;
+	size_t zone_iter = 0;
+
+	while (zone && zone_iter < zone_list_limit(type)) {
+		t_zone *next_zone = zone->next;
+		int empty = is_zone_empty(zone);
+
+		if (empty && *retained + zone->total_size <= pad) {
+			*retained += zone->total_size;
+			prev = zone;
+		} else if (empty) {
+			if (prev)
+				prev->next = next_zone;
+			else
+				g_manager.zones[type] = next_zone;
+			if (type != ZONE_LARGE && g_manager.zone_counts[type] > 0)
+				g_manager.zone_counts[type]--;
+			report->zones_released[type]++;
+			report->bytes_unmapped[type] += zone->total_size;
+			unmap_zone(zone);
+		} else {
+			report->bytes_purged[type] += purge_zone(zone);
+			prev = zone;
+		}
+
+		zone = next_zone;
+		zone_iter++;
+	}
+}
+
+size_t malloc_trim_ex(size_t pad, t_malloc_trim_report *report)
+{
+	t_malloc_trim_report local;
+	size_t retained = 0;
+
+	if (!report)
+		report = &local;
+	ft_memset(report, 0, sizeof(t_malloc_trim_report));
+
+	malloc_lock(MALLOC_LOCK_MAINTENANCE);
+
+	for (int type = 0; type < 3; type++)
+		trim_zones_of_type(type, &retained, pad, report);
+
+	malloc_unlock();
+	hook_flush();
+
+	for (int type = 0; type < 3; type++)
+		report->bytes_released += report->bytes_unmapped[type] +
+			report->bytes_purged[type];
+
+	return report->bytes_released;
+}
+
+int malloc_trim(size_t pad)
+{
+	return malloc_trim_ex(pad, NULL) > 0;
+}
@@ -0,0 +1,42 @@
+#define _GNU_SOURCE
+#include "../../include/malloc_internal.h"
+#include <sys/mman.h>
+
+#ifndef MAP_ANONYMOUS
+#ifdef MAP_ANON
+#define MAP_ANONYMOUS MAP_ANON
+#else
+#define MAP_ANONYMOUS 0x20
+#endif
+#endif
+
+void *vm_map(size_t size)
+{
+    void *ptr = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (ptr == MAP_FAILED) {
+        stats_record_vm(VM_MMAP, 0);
+        return NULL;
+    }
+    stats_record_vm(VM_MMAP, size);
+    return ptr;
+}
+
+void vm_unmap(void *ptr, size_t size)
+{
+    if (munmap(ptr, size) == 0)
+        stats_record_vm(VM_MUNMAP, size);
+    else
+        stats_record_vm(VM_MUNMAP, 0);
+}
+
+int vm_purge(void *ptr, size_t size)
+{
+    if (madvise(ptr, size, MADV_DONTNEED) != 0) {
+        stats_record_vm(VM_MADVISE, 0);
+        return -1;
+    }
+    stats_record_vm(VM_MADVISE, size);
+    return 0;
+}
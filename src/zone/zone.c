@@ -1,21 +1,12 @@
 #define _GNU_SOURCE
 #include "../../include/malloc_internal.h"
-#include <sys/mman.h>
 #include <unistd.h>
 
-#ifndef MAP_ANONYMOUS
-#ifdef MAP_ANON
-#define MAP_ANONYMOUS MAP_ANON
-#else
-#define MAP_ANONYMOUS 0x20
-#endif
-#endif
-
 t_zone_type get_zone_type(size_t size)
 {
-    if (size <= TINY_MAX)
+    if (size <= g_manager.config.tiny_max)
         return ZONE_TINY;
-    if (size <= SMALL_MAX)
+    if (size <= g_manager.config.small_max)
         return ZONE_SMALL;
     return ZONE_LARGE;
 }
@@ -23,14 +14,16 @@ t_zone_type get_zone_type(size_t size)
 size_t get_zone_size(t_zone_type type)
 {
     if (type == ZONE_TINY)
-        return TINY_ZONE_SIZE;
+        return g_manager.config.tiny_zone_size;
     if (type == ZONE_SMALL)
-        return SMALL_ZONE_SIZE;
+        return g_manager.config.small_zone_size;
     return 0;
 }
 
 t_zone *create_zone(t_zone_type type, size_t min_size)
 {
+    config_init();
+
     if (type != ZONE_LARGE) {
         if (g_manager.zone_counts[type] >= MAX_ZONES_PER_TYPE)
             return NULL;
@@ -44,9 +37,8 @@ t_zone *create_zone(t_zone_type type, size_t min_size)
         zone_size = ((zone_size + page_size - 1) / page_size) * page_size;
     }
 
-    void *ptr = mmap(NULL, zone_size, PROT_READ | PROT_WRITE,
-                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
-    if (ptr == MAP_FAILED)
+    void *ptr = vm_map(zone_size);
+    if (!ptr)
         return NULL;
 
     t_zone *zone = (t_zone *)ptr;
@@ -63,14 +55,23 @@ t_zone *create_zone(t_zone_type type, size_t min_size)
     if (type != ZONE_LARGE)
         g_manager.zone_counts[type]++;
 
+    stats_record_zone_map(zone);
     return zone;
 }
 
+size_t zone_list_limit(int type)
+{
+    if (type == ZONE_LARGE)
+        return SIZE_MAX;
+    return MAX_ZONES_PER_TYPE;
+}
+
 void add_zone_to_manager(t_zone *zone)
 {
     t_zone_type type = zone->type;
 
-    if (!g_manager.zones[type]) {
+    if (!g_manager.zones[type] || type == ZONE_LARGE) {
+        zone->next = g_manager.zones[type];
         g_manager.zones[type] = zone;
     } else {
         t_zone *current = g_manager.zones[type];
@@ -96,7 +97,7 @@ t_zone *find_or_create_zone(t_zone_type type, size_t size)
     }
 
     int iterations = 0;
-    while (zone && iterations < MAX_ZONE_SEARCH) {
+    while (zone && iterations < (int)g_manager.config.max_zone_search) {
         t_chunk *chunk = find_free_chunk(zone, size);
         if (chunk)
             return zone;
@@ -119,8 +120,8 @@ t_zone *find_zone_for_chunk(t_chunk *chunk)
 {
     for (int type = 0; type < 3; type++) {
         t_zone *zone = g_manager.zones[type];
-        int iterations = 0;
-        while (zone && iterations < MAX_ZONES_PER_TYPE) {
+        size_t iterations = 0;
+        while (zone && iterations < zone_list_limit(type)) {
             if ((void *)chunk >= zone->start && (void *)chunk < zone->end)
                 return zone;
             zone = zone->next;
@@ -138,9 +139,9 @@ void remove_zone_from_manager(t_zone *zone)
     t_zone_type type = zone->type;
     t_zone *current = g_manager.zones[type];
     t_zone *prev = NULL;
-    int iterations = 0;
+    size_t iterations = 0;
 
-    while (current && iterations < MAX_ZONES_PER_TYPE) {
+    while (current && iterations < zone_list_limit(type)) {
         if (current == zone) {
             if (prev)
                 prev->next = zone->next;
@@ -157,6 +158,12 @@ void remove_zone_from_manager(t_zone *zone)
     }
 }
 
+void unmap_zone(t_zone *zone)
+{
+    stats_record_zone_unmap(zone);
+    vm_unmap(zone->start, zone->total_size);
+}
+
 int is_zone_empty(t_zone *zone)
 {
     if (!zone || !zone->chunks)
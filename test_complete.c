@@ -1,6 +1,15 @@
+#define _GNU_SOURCE
 #include "include/malloc.h"
 #include <unistd.h>
 #include <string.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <sys/wait.h>
+
+void *ft_memcpy(void *dst, const void *src, size_t n);
+void *ft_memset(void *b, int c, size_t len);
 
 static void print_str(const char *str)
 {
@@ -115,6 +124,32 @@ static int test_realloc_grow(void)
 	return 1;
 }
 
+static int test_realloc_copy_large(void)
+{
+	size_t size = 1024 * 1024 + 7;
+	unsigned char *ptr = malloc(size);
+	size_t i;
+
+	if (!ptr)
+		return 0;
+	for (i = 0; i < size; i++)
+		ptr[i] = (unsigned char)(i * 31);
+
+	unsigned char *grown = realloc(ptr, 2 * size);
+	if (!grown)
+		return 0;
+
+	for (i = 0; i < size; i++) {
+		if (grown[i] != (unsigned char)(i * 31)) {
+			free(grown);
+			return 0;
+		}
+	}
+
+	free(grown);
+	return 1;
+}
+
 static int test_realloc_shrink(void)
 {
 	void *ptr = malloc(200);
@@ -142,6 +177,26 @@ static int test_alignment(void)
 	return aligned;
 }
 
+static int test_malloc_aligned(void)
+{
+	size_t alignments[] = {32, 64, 256, 4096, 65536};
+	int i;
+
+	for (i = 0; i < 5; i++) {
+		void *ptr = malloc_aligned(alignments[i], 100);
+		if (!ptr || (unsigned long)ptr % alignments[i] != 0)
+			return 0;
+		free_sized(ptr, 100);
+	}
+
+	void *large = malloc_aligned(128, 5000);
+	if (!large || (unsigned long)large % 128 != 0)
+		return 0;
+	free(large);
+
+	return malloc_aligned(24, 100) == NULL;
+}
+
 static int test_show_alloc_mem(void)
 {
 	void *ptr1 = malloc(64);
@@ -160,6 +215,77 @@ static int test_show_alloc_mem(void)
 	return 1;
 }
 
+static int test_show_alloc_mem_fd(void)
+{
+	char path[] = "/tmp/ft_malloc_dumpXXXXXX";
+	t_malloc_dump_header header;
+	t_malloc_dump_record records[2];
+	char json[16];
+	void *ptr = malloc(64);
+	int fd = mkstemp(path);
+
+	if (!ptr || fd < 0)
+		return 0;
+	unlink(path);
+
+	int ok = show_alloc_mem_fd(fd, MALLOC_DUMP_BINARY) == 0 &&
+		lseek(fd, 0, SEEK_SET) == 0 &&
+		read(fd, &header, sizeof(header)) == sizeof(header) &&
+		read(fd, records, sizeof(records)) == sizeof(records);
+	ok = ok && memcmp(header.magic, MALLOC_DUMP_MAGIC, 8) == 0 &&
+		header.record_size == sizeof(t_malloc_dump_record) &&
+		header.record_count >= 2 &&
+		records[0].kind == MALLOC_DUMP_ZONE &&
+		records[1].kind == MALLOC_DUMP_CHUNK &&
+		records[1].start > records[0].start;
+
+	ok = ok && ftruncate(fd, 0) == 0 && lseek(fd, 0, SEEK_SET) == 0 &&
+		show_alloc_mem_fd(fd, MALLOC_DUMP_JSON) == 0 &&
+		lseek(fd, 0, SEEK_SET) == 0 &&
+		read(fd, json, 10) == 10 && memcmp(json, "{\"zones\":[", 10) == 0;
+
+	close(fd);
+	free(ptr);
+	return ok && show_alloc_mem_fd(-1, MALLOC_DUMP_TEXT) == -1;
+}
+
+static int test_heap_snapshot(void)
+{
+	char path[] = "/tmp/ft_malloc_snapXXXXXX";
+	t_malloc_heap_header header;
+	t_malloc_heap_record record;
+	size_t on = 1;
+	size_t off = 0;
+	malloc_ctl("leak.report", NULL, NULL, &on, sizeof(on));
+	void *ptr = malloc(77);
+	malloc_ctl("leak.report", NULL, NULL, &off, sizeof(off));
+	int fd = mkstemp(path);
+	int found = 0;
+
+	if (!ptr || fd < 0)
+		return 0;
+	unlink(path);
+
+	if (heap_snapshot(fd) != 0 || lseek(fd, 0, SEEK_SET) != 0 ||
+		read(fd, &header, sizeof(header)) != sizeof(header)) {
+		close(fd);
+		return 0;
+	}
+
+	while (read(fd, &record, sizeof(record)) == sizeof(record)) {
+		if (record.address == (uint64_t)(uintptr_t)ptr)
+			found = record.size == 77 && record.site != 0 &&
+				record.size_class < MALLOC_SIZE_CLASSES &&
+				header.class_max[record.size_class] >= 77;
+	}
+
+	close(fd);
+	free(ptr);
+	return found && memcmp(header.magic, MALLOC_HEAP_MAGIC, 8) == 0 &&
+		header.record_size == sizeof(t_malloc_heap_record) &&
+		header.live_bytes >= 77 && heap_snapshot(-1) == -1;
+}
+
 static int test_malloc_cleanup(void)
 {
 	void *ptr1 = malloc(100);
@@ -226,6 +352,31 @@ static int test_stress_large(void)
 	return 1;
 }
 
+static int test_many_large_zones(void)
+{
+	static void *ptrs[1100];
+	t_malloc_stats before;
+	t_malloc_stats live;
+	t_malloc_stats after;
+	int ok = 1;
+	int i;
+
+	get_malloc_stats(&before);
+	for (i = 0; i < 1100; i++) {
+		ptrs[i] = malloc(5000);
+		if (!ptrs[i])
+			ok = 0;
+	}
+	get_malloc_stats(&live);
+	for (i = 0; i < 1100; i++)
+		free(ptrs[i]);
+	get_malloc_stats(&after);
+
+	return ok && live.zones_by_type[2] == before.zones_by_type[2] + 1100 &&
+		after.zones_by_type[2] == before.zones_by_type[2] &&
+		after.errors_count == before.errors_count;
+}
+
 static int test_fragmentation(void)
 {
 	void *ptrs[50];
@@ -274,11 +425,1005 @@ static int test_invalid_free(void)
 	return 1;
 }
 
-int main(void)
+static int test_stats_counters(void)
+{
+	t_malloc_stats before;
+	t_malloc_stats during;
+	t_malloc_stats after;
+
+	if (get_malloc_stats(&before) != 0)
+		return 0;
+
+	void *volatile tiny = malloc(32);
+	void *large = malloc(10000);
+	if (!tiny || !large || get_malloc_stats(&during) != 0)
+		return 0;
+
+	free(tiny);
+	free(tiny);
+	free(large);
+	if (get_malloc_stats(&after) != 0)
+		return 0;
+
+	return during.allocs_tiny == before.allocs_tiny + 1 &&
+		during.allocs_large == before.allocs_large + 1 &&
+		during.bytes_allocated >= before.bytes_allocated + 32 + 10000 &&
+		during.bytes_peak >= during.bytes_allocated &&
+		during.zones_total > before.zones_total &&
+		after.bytes_allocated == before.bytes_allocated &&
+		after.zones_active < during.zones_active &&
+		after.errors_count > before.errors_count &&
+		after.update_time != 0;
+}
+
+static int test_size_classes(void)
+{
+	t_malloc_size_class before[MALLOC_SIZE_CLASSES];
+	t_malloc_size_class during[MALLOC_SIZE_CLASSES];
+	void *ptrs[3];
+	int i;
+
+	if (get_malloc_size_classes(before, MALLOC_SIZE_CLASSES) != MALLOC_SIZE_CLASSES)
+		return 0;
+
+	for (i = 0; i < 3; i++) {
+		ptrs[i] = malloc(20);
+		if (!ptrs[i])
+			return 0;
+	}
+
+	get_malloc_size_classes(during, MALLOC_SIZE_CLASSES);
+	for (i = 0; i < 3; i++)
+		free(ptrs[i]);
+
+	return before[1].size_max == 32 &&
+		during[1].count == before[1].count + 3 &&
+		during[1].allocs == before[1].allocs + 3 &&
+		during[1].bytes_in_use == before[1].bytes_in_use + 60 &&
+		during[1].bytes_wasted >= before[1].bytes_wasted + 36;
+}
+
+static int test_heap_profiler(void)
+{
+	size_t period = 1;
+	size_t off = 0;
+	int fds[2];
+	char buffer[256];
+
+	if (malloc_ctl("prof.sample", NULL, NULL, &period, sizeof(period)) != 0)
+		return 0;
+
+	void *ptr = malloc(4000);
+	if (!ptr || pipe(fds) != 0)
+		return 0;
+
+	int dumped = malloc_prof_dump(fds[1]);
+	malloc_ctl("prof.sample", NULL, NULL, &off, sizeof(off));
+	close(fds[1]);
+	ssize_t len = read(fds[0], buffer, sizeof(buffer) - 1);
+	close(fds[0]);
+	free(ptr);
+
+	if (dumped != 0 || len <= 0)
+		return 0;
+	buffer[len] = '\0';
+	return strncmp(buffer, "heap profile: ", 14) == 0 &&
+		strstr(buffer, "heap_v2/1") != NULL &&
+		strstr(buffer, ": 4000 [") != NULL;
+}
+
+static int test_vm_counters(void)
+{
+	t_malloc_stats before;
+	t_malloc_stats mapped;
+	t_malloc_stats after;
+
+	get_malloc_stats(&before);
+	char *ptr = malloc(200000);
+	if (!ptr)
+		return 0;
+	for (size_t i = 0; i < 200000; i += 4096)
+		ptr[i] = 1;
+	get_malloc_stats(&mapped);
+	free(ptr);
+	get_malloc_stats(&after);
+
+	return mapped.mmap_calls == before.mmap_calls + 1 &&
+		mapped.mmap_bytes >= before.mmap_bytes + 200000 &&
+		after.munmap_calls == mapped.munmap_calls + 1 &&
+		after.munmap_bytes - mapped.munmap_bytes == mapped.mmap_bytes - before.mmap_bytes &&
+		after.mremap_calls == 0 &&
+		mapped.minor_faults >= before.minor_faults + 40;
+}
+
+static int test_stats_shm_page(void)
+{
+	const char *path = "/dev/shm/ft_malloc_test_stats";
+	t_malloc_stats_page page;
+	t_malloc_stats stats;
+	void *ptr;
+	int fd;
+
+	if (malloc_stats_shm_start("../ft_malloc_test_stats") == 0 ||
+		malloc_stats_shm_start("/tmp/ft_malloc_test_stats") == 0)
+		return 0;
+	if (malloc_stats_shm_start("ft_malloc_test_stats") != 0)
+		return 0;
+	if (malloc_stats_shm_start("ft_malloc_test_stats") == 0)
+		return 0;
+
+	ptr = malloc(300);
+	fd = open(path, O_RDONLY);
+	if (!ptr || fd < 0)
+		return 0;
+	int ok = read(fd, &page, sizeof(page)) == (ssize_t)sizeof(page);
+	close(fd);
+	get_malloc_stats(&stats);
+	free(ptr);
+
+	if (malloc_stats_shm_stop() != 0 || access(path, F_OK) == 0)
+		return 0;
+
+	fd = open(path, O_CREAT | O_WRONLY, 0600);
+	ok = ok && fd >= 0 && malloc_stats_shm_start("ft_malloc_test_stats") != 0;
+	close(fd);
+	unlink(path);
+
+	return ok && memcmp(page.magic, MALLOC_STATS_SHM_MAGIC, 8) == 0 &&
+		page.sequence % 2 == 0 && page.pid == (uint64_t)getpid() &&
+		page.bytes_allocated == stats.bytes_allocated &&
+		page.zones_by_type[1] == stats.zones_by_type[1] &&
+		page.reuse_hits + page.reuse_misses == stats.reuse_hits + stats.reuse_misses;
+}
+
+static const t_malloc_zone_residency *find_residency(const t_malloc_zone_residency *zones,
+	int count, void *ptr)
+{
+	for (int i = 0; i < count && i < 64; i++) {
+		if ((uintptr_t)ptr >= zones[i].start &&
+			(uintptr_t)ptr < zones[i].start + zones[i].mapped)
+			return &zones[i];
+	}
+	return NULL;
+}
+
+static int test_residency(void)
+{
+	t_malloc_zone_residency zones[64];
+	t_malloc_residency report;
+	char *touched = malloc(256 * 1024);
+	char *untouched = malloc(4 * 1024 * 1024);
+	int count;
+
+	if (!touched || !untouched)
+		return 0;
+	memset(touched, 1, 256 * 1024);
+
+	count = get_malloc_residency(&report, zones, 64);
+	const t_malloc_zone_residency *hot = find_residency(zones, count, touched);
+	const t_malloc_zone_residency *cold = find_residency(zones, count, untouched);
+	int ok = hot && cold && hot->type == 2 && cold->type == 2 &&
+		hot->resident >= 256 * 1024 && hot->resident <= hot->mapped &&
+		cold->resident < cold->mapped / 2 &&
+		hot->header_bytes >= 48 && hot->chunks == 1 &&
+		report.resident <= report.mapped && report.mapped >= hot->mapped + cold->mapped;
+
+	free(touched);
+	free(untouched);
+	return ok;
+}
+
+static int test_fragmentation_report(void)
+{
+	t_malloc_zone_frag zones[64];
+	t_malloc_frag_report report;
+	const t_malloc_zone_frag *zone = NULL;
+	void *ptrs[5];
+	size_t runs = 0;
+	int count;
+	int i;
+
+	for (i = 0; i < 5; i++) {
+		ptrs[i] = malloc(512);
+		if (!ptrs[i])
+			return 0;
+	}
+	free(ptrs[1]);
+	free(ptrs[3]);
+
+	count = get_malloc_fragmentation(&report, zones, 64);
+	for (i = 0; i < count && i < 64; i++) {
+		if ((uintptr_t)ptrs[1] >= zones[i].start &&
+			(uintptr_t)ptrs[1] < zones[i].start + zones[i].total_size)
+			zone = &zones[i];
+	}
+	for (i = 0; i < MALLOC_FRAG_BUCKETS; i++)
+		runs += report.run_histogram[i];
+
+	free(ptrs[0]);
+	free(ptrs[2]);
+	free(ptrs[4]);
+
+	return count > 0 && zone && zone->type == 1 &&
+		zone->free_runs >= 2 && zone->free_bytes >= 1024 &&
+		zone->largest_free_run >= 512 &&
+		zone->bump_remaining == zone->total_size - zone->used_size &&
+		zone->external_fragmentation >= 0.0 && zone->external_fragmentation < 1.0 &&
+		runs == report.free_runs && report.free_bytes >= zone->free_bytes &&
+		report.external_fragmentation >= 0.0 && report.external_fragmentation < 1.0;
+}
+
+static int test_latency_histograms(void)
+{
+	size_t on = 1;
+	size_t off = 0;
+	t_malloc_latency lat;
+	uint64_t buckets = 0;
+	int i;
+
+	malloc_latency_reset();
+	if (malloc_ctl("latency.enabled", NULL, NULL, &on, sizeof(on)) != 0)
+		return 0;
+
+	void *tiny = malloc(24);
+	void *large = malloc(200000);
+	void *grown = realloc(tiny, 48);
+	free(grown);
+	free(large);
+	void *aligned = malloc_aligned(64, 300);
+	free_sized(aligned, 300);
+	malloc_ctl("latency.enabled", NULL, NULL, &off, sizeof(off));
+
+	if (!large || !grown || !aligned || get_malloc_latency(&lat) != 0)
+		return 0;
+	for (i = 0; i < MALLOC_LATENCY_BUCKETS; i++)
+		buckets += lat.ops[MALLOC_OP_MALLOC][0].buckets[i];
+
+	return lat.ops[MALLOC_OP_MALLOC][0].count == 1 &&
+		buckets == 1 &&
+		lat.ops[MALLOC_OP_MALLOC][2].mmap_calls == 1 &&
+		lat.ops[MALLOC_OP_FREE][2].munmap_calls == 1 &&
+		lat.ops[MALLOC_OP_REALLOC][0].count == 1 &&
+		lat.ops[MALLOC_OP_FREE][0].count == 1 &&
+		lat.ops[MALLOC_OP_MALLOC][1].count == 1 &&
+		lat.ops[MALLOC_OP_FREE][1].count == 1;
+}
+
+static int test_lock_stats(void)
+{
+	t_malloc_lock_stats before;
+	t_malloc_lock_stats after;
+	size_t acquired = 0;
+	size_t len = sizeof(acquired);
+	uint64_t sum = 0;
+	int i;
+
+	if (get_malloc_lock_stats(&before) != 0)
+		return 0;
+
+	t_malloc_hooks hooks = {NULL, NULL, NULL, NULL, NULL, NULL};
+	void *ptr = malloc(64);
+	free(ptr);
+	malloc_hooks_unregister(malloc_hooks_register(&hooks));
+	if (malloc_ctl("stats.lock.acquired", &acquired, &len, NULL, 0) != 0 ||
+		get_malloc_lock_stats(&after) != 0)
+		return 0;
+
+	for (i = 0; i <= MALLOC_LOCK_MAINTENANCE; i++)
+		sum += after.sites[i].acquisitions;
+
+	return after.sites[MALLOC_LOCK_MALLOC].acquisitions ==
+			before.sites[MALLOC_LOCK_MALLOC].acquisitions + 1 &&
+		after.sites[MALLOC_LOCK_FREE].acquisitions ==
+			before.sites[MALLOC_LOCK_FREE].acquisitions + 1 &&
+		after.sites[MALLOC_LOCK_HOOKS].acquisitions ==
+			before.sites[MALLOC_LOCK_HOOKS].acquisitions + 2 &&
+		after.acquisitions == sum &&
+		acquired >= before.acquisitions + 2 &&
+		after.contended >= before.contended;
+}
+
+static int test_trace_recorder(void)
+{
+	char path[] = "/tmp/ft_malloc_traceXXXXXX";
+	t_malloc_trace_header header;
+	t_malloc_trace_record records[6];
+	int fd = mkstemp(path);
+
+	if (fd < 0)
+		return 0;
+	close(fd);
+
+	if (malloc_trace_start(path) != -1 || unlink(path) != 0)
+		return 0;
+	if (malloc_trace_start(path) != 0 || malloc_trace_start(path) != -1)
+		return 0;
+	void *ptr = malloc(40);
+	uint64_t ptr_id = (uint64_t)(uintptr_t)ptr;
+	void *grown = realloc(ptr, 4000);
+	uint64_t grown_id = (uint64_t)(uintptr_t)grown;
+	free(grown);
+	void *aligned = malloc_aligned(256, 100);
+	uint64_t aligned_id = (uint64_t)(uintptr_t)aligned;
+	free_sized(aligned, 100);
+	malloc_trace_stop();
+
+	fd = open(path, O_RDONLY);
+	unlink(path);
+	if (fd < 0)
+		return 0;
+	ssize_t len = read(fd, &header, sizeof(header));
+	ssize_t body = read(fd, records, sizeof(records));
+	close(fd);
+
+	return len == sizeof(header) && body == 5 * sizeof(t_malloc_trace_record) &&
+		memcmp(header.magic, MALLOC_TRACE_MAGIC, 8) == 0 &&
+		records[0].op == MALLOC_OP_MALLOC && records[0].size == 40 &&
+		records[0].ptr == ptr_id &&
+		records[1].op == MALLOC_OP_REALLOC && records[1].old_ptr == records[0].ptr &&
+		records[1].ptr == grown_id &&
+		records[2].op == MALLOC_OP_FREE && records[2].old_ptr == records[1].ptr &&
+		records[2].timestamp >= records[0].timestamp &&
+		records[3].op == MALLOC_OP_MALLOC && records[3].size == 100 &&
+		records[3].ptr == aligned_id && aligned_id % 256 == 0 &&
+		records[4].op == MALLOC_OP_FREE && records[4].old_ptr == aligned_id &&
+		malloc_trace_stop() == -1;
+}
+
+__attribute__((noinline))
+static void *leak_alloc(size_t size)
+{
+	return malloc(size);
+}
+
+static int test_leak_report(void)
+{
+	char path[] = "/tmp/ft_malloc_leakXXXXXX";
+	char buffer[256];
+	size_t on = 1;
+	size_t off = 0;
+	int fd = mkstemp(path);
+
+	if (fd < 0)
+		return 0;
+	unlink(path);
+
+	malloc_ctl("leak.report", NULL, NULL, &on, sizeof(on));
+	void *first = leak_alloc(300);
+	void *second = leak_alloc(300);
+	free(malloc(50));
+	int leaks = malloc_leak_report(fd);
+	free(first);
+	free(second);
+	int after = malloc_leak_report(fd);
+	malloc_ctl("leak.report", NULL, NULL, &off, sizeof(off));
+
+	lseek(fd, 0, SEEK_SET);
+	ssize_t len = read(fd, buffer, sizeof(buffer) - 1);
+	close(fd);
+	if (len <= 0)
+		return 0;
+	buffer[len] = '\0';
+
+	return leaks == 2 && after == 0 &&
+		strncmp(buffer, "=== Leak Report: 600 bytes in 2 allocations from 1 sites ===\n"
+			"  600 bytes in 2 allocations from ", 95) == 0;
+}
+
+typedef struct s_hook_counts {
+	int mallocs;
+	int frees;
+	int reallocs;
+	int zones_created;
+	int zones_destroyed;
+	void *last;
+} t_hook_counts;
+
+static void count_malloc(void *arg, void *ptr, size_t size)
+{
+	t_hook_counts *counts = arg;
+	void *scratch = malloc(size);
+
+	counts->mallocs++;
+	counts->last = ptr;
+	free(scratch);
+}
+
+static void count_free(void *arg, void *ptr)
+{
+	((t_hook_counts *)arg)->frees++;
+	((t_hook_counts *)arg)->last = ptr;
+}
+
+static void count_realloc(void *arg, void *old_ptr, void *new_ptr, size_t size)
+{
+	(void)old_ptr;
+	(void)size;
+	((t_hook_counts *)arg)->reallocs++;
+	((t_hook_counts *)arg)->last = new_ptr;
+}
+
+static void count_zone_create(void *arg, void *start, size_t size, int type)
+{
+	(void)start;
+	(void)size;
+	if (type == 2)
+		((t_hook_counts *)arg)->zones_created++;
+}
+
+static void count_zone_destroy(void *arg, void *start, size_t size, int type)
+{
+	(void)start;
+	(void)size;
+	if (type == 2)
+		((t_hook_counts *)arg)->zones_destroyed++;
+}
+
+static int test_hooks(void)
+{
+	t_hook_counts counts = {0, 0, 0, 0, 0, NULL};
+	t_malloc_hooks hooks = {count_malloc, count_free, count_realloc,
+		count_zone_create, count_zone_destroy, &counts};
+	int id = malloc_hooks_register(&hooks);
+	void *ptr;
+	void *large;
+	int ok;
+
+	if (id < 0)
+		return 0;
+
+	ptr = malloc(40);
+	ok = counts.mallocs == 1 && counts.last == ptr;
+	ptr = realloc(ptr, 4000);
+	ok = ok && counts.reallocs == 1 && counts.frees == 0 && counts.last == ptr;
+	free(ptr);
+	ok = ok && counts.frees == 1 && counts.last == ptr;
+	large = malloc(1024 * 1024);
+	free(large);
+	ok = ok && counts.mallocs == 2 && counts.zones_created >= 1 &&
+		counts.zones_destroyed >= 1;
+
+	if (malloc_hooks_unregister(id) != 0 || malloc_hooks_unregister(id) == 0)
+		return 0;
+	free(malloc(40));
+	return ok && counts.mallocs == 2 && counts.frees == 2;
+}
+
+static int g_swap_id = -1;
+static int g_swap_new_id = -1;
+
+static void swap_hooks(void *arg, void *ptr, size_t size)
+{
+	t_malloc_hooks next = {NULL, NULL, NULL, NULL, NULL, arg};
+
+	(void)ptr;
+	(void)size;
+	if (g_swap_new_id >= 0)
+		return;
+	malloc_hooks_unregister(g_swap_id);
+	g_swap_new_id = malloc_hooks_register(&next);
+}
+
+static int test_hook_slot_reuse(void)
+{
+	t_malloc_hooks hooks = {swap_hooks, NULL, NULL, NULL, NULL, NULL};
+	int ok;
+
+	g_swap_new_id = -1;
+	g_swap_id = malloc_hooks_register(&hooks);
+	if (g_swap_id < 0)
+		return 0;
+	free(malloc(40));
+	ok = g_swap_new_id >= 0 && g_swap_new_id != g_swap_id;
+	malloc_hooks_unregister(g_swap_new_id);
+	return ok;
+}
+
+static int test_hook_zone_drops(void)
+{
+	t_hook_counts counts = {0, 0, 0, 0, 0, NULL};
+	t_malloc_hooks hooks = {NULL, NULL, NULL, NULL, count_zone_destroy, &counts};
+	t_malloc_stats before;
+	t_malloc_stats after;
+	static void *ptrs[32768];
+	size_t count = 0;
+	int id;
+
+	get_malloc_stats(&before);
+	while (count < 32768) {
+		get_malloc_stats(&after);
+		if (after.zones_by_type[0] >= before.zones_by_type[0] + 40)
+			break;
+		ptrs[count++] = malloc(100);
+	}
+	for (size_t i = 0; i < count; i++)
+		free(ptrs[i]);
+	id = malloc_hooks_register(&hooks);
+	if (id < 0)
+		return 0;
+	malloc_trim(0);
+	malloc_hooks_unregister(id);
+	get_malloc_stats(&after);
+	return counts.zones_destroyed == 0 &&
+		after.hook_events_dropped >= before.hook_events_dropped + 8;
+}
+
+static void *thread_stats_worker(void *arg)
+{
+	void **ptrs = arg;
+
+	for (int i = 0; i < 3; i++)
+		ptrs[i] = malloc(100000);
+	return NULL;
+}
+
+static int test_thread_stats(void)
+{
+	t_malloc_thread_stats before[64];
+	t_malloc_thread_stats after[64];
+	const t_malloc_thread_stats *worker = NULL;
+	const t_malloc_thread_stats *self = NULL;
+	const t_malloc_thread_stats *self_before = NULL;
+	void *ptrs[3] = {NULL, NULL, NULL};
+	pthread_t thread;
+	int count;
+	int i;
+
+	count = get_malloc_thread_stats(before, 64);
+	if (pthread_create(&thread, NULL, thread_stats_worker, ptrs) != 0)
+		return 0;
+	pthread_join(thread, NULL);
+	free(ptrs[0]);
+
+	int after_count = get_malloc_thread_stats(after, 64);
+	for (i = 0; i < after_count; i++) {
+		if (!worker && after[i].allocs == 3 && !after[i].alive)
+			worker = &after[i];
+		if (after[i].thread_id == (uint64_t)gettid() && after[i].alive)
+			self = &after[i];
+	}
+	for (i = 0; i < count; i++) {
+		if (before[i].thread_id == (uint64_t)gettid())
+			self_before = &before[i];
+	}
+	free(ptrs[1]);
+	free(ptrs[2]);
+
+	return worker && self && self_before && after_count <= count + 1 &&
+		worker->bytes_in_flight >= 200000 && worker->bytes_in_flight < 300000 &&
+		worker->bytes_allocated >= 300000 &&
+		self->remote_frees == self_before->remote_frees + 1 &&
+		(after_count < 2 || after[0].bytes_in_flight >= after[1].bytes_in_flight);
+}
+
+static void *thread_slot_worker(void *arg)
+{
+	void *ptr = malloc(64);
+
+	*(uint64_t *)arg = (uint64_t)gettid();
+	free(ptr);
+	return NULL;
+}
+
+static void *thread_slot_keeper(void *arg)
+{
+	((void **)arg)[0] = malloc(64);
+	((uint64_t *)arg)[1] = (uint64_t)gettid();
+	return NULL;
+}
+
+static int test_thread_slot_reuse(void)
+{
+	static t_malloc_thread_stats threads[1024];
+	uint64_t tid;
+	void *kept[2] = {NULL, NULL};
+	pthread_t thread;
+	int found = 0;
+
+	for (int i = 0; i < 1100; i++) {
+		if (pthread_create(&thread, NULL, thread_slot_worker, &tid) != 0)
+			return 0;
+		pthread_join(thread, NULL);
+	}
+	if (pthread_create(&thread, NULL, thread_slot_keeper, kept) != 0)
+		return 0;
+	pthread_join(thread, NULL);
+
+	int count = get_malloc_thread_stats(threads, 1024);
+	for (int i = 0; i < count; i++) {
+		if (threads[i].thread_id == (uint64_t)kept[1] && threads[i].index != 0)
+			found = 1;
+	}
+	free(kept[0]);
+	return found;
+}
+
+static int test_pool_alloc_free(void)
+{
+	t_malloc_pool *pool = pool_create(40, 64);
+	void *ptrs[200];
+	int i;
+
+	if (!pool)
+		return 0;
+
+	for (i = 0; i < 200; i++) {
+		ptrs[i] = pool_alloc(pool);
+		if (!ptrs[i] || (unsigned long)ptrs[i] % 64 != 0)
+			return 0;
+	}
+
+	for (i = 0; i < 200; i++)
+		pool_free(pool, ptrs[i]);
+
+	void *again = pool_alloc(pool);
+	int reused = (again == ptrs[199]);
+
+	pool_free(pool, again);
+	pool_destroy(pool);
+	return reused;
+}
+
+static int test_pool_invalid_free(void)
+{
+	t_malloc_pool *pool = pool_create(32, 0);
+	t_malloc_pool *other = pool_create(32, 0);
+	t_malloc_stats before;
+	t_malloc_stats after;
+
+	if (!pool || !other)
+		return 0;
+
+	void *ptr = pool_alloc(pool);
+	void *foreign = pool_alloc(other);
+	void *heap = malloc(32);
+	get_malloc_stats(&before);
+	pool_free(pool, (void *)(uintptr_t)0x10010);
+	pool_free(pool, heap);
+	pool_free(pool, foreign);
+	pool_free(pool, ptr);
+	pool_free(pool, ptr);
+	get_malloc_stats(&after);
+
+	void *first = pool_alloc(pool);
+	void *second = pool_alloc(pool);
+	int ok = after.errors_count == before.errors_count + 1 &&
+		first == ptr && second != ptr;
+
+	free(heap);
+	pool_free(other, foreign);
+	pool_destroy(other);
+	pool_destroy(pool);
+	return ok;
+}
+
+#define POOL_TEST_OBJECTS 2400
+
+static int test_pool_many_slabs(void)
+{
+	t_malloc_pool *pool = pool_create(8192, 0);
+	void **objects = malloc(POOL_TEST_OBJECTS * sizeof(void *));
+	t_malloc_stats before;
+	t_malloc_stats after;
+	int count = 0;
+
+	if (!pool || !objects)
+		return 0;
+
+	while (count < POOL_TEST_OBJECTS && (objects[count] = pool_alloc(pool)))
+		count++;
+	get_malloc_stats(&before);
+	for (int i = 0; i < count; i++)
+		pool_free(pool, objects[i]);
+	pool_free(pool, objects[0]);
+	get_malloc_stats(&after);
+
+	int ok = count == POOL_TEST_OBJECTS && before.pool_slabs >= 300 &&
+		after.errors_count == before.errors_count + 1;
+
+	free(objects);
+	pool_destroy(pool);
+	return ok;
+}
+
+static int test_pool_stats(void)
+{
+	t_malloc_pool *pool = pool_create(24, 0);
+	t_malloc_stats before;
+	t_malloc_stats stats;
+	t_malloc_stats after;
+
+	if (!pool || get_malloc_stats(&before) != 0)
+		return 0;
+
+	void *ptr = pool_alloc(pool);
+	if (!ptr || get_malloc_stats(&stats) != 0)
+		return 0;
+	pool_free(pool, ptr);
+	get_malloc_stats(&after);
+
+	int ok = (stats.pools_active >= 1 && stats.pool_slabs >= 1 &&
+		stats.pool_objects_in_use == before.pool_objects_in_use + 1 &&
+		after.pool_objects_in_use == before.pool_objects_in_use);
+
+	pool_destroy(pool);
+	return ok;
+}
+
+#define KERNEL_GUARD 64
+#define KERNEL_BUFFER ((1 << 20) + 4 * KERNEL_GUARD)
+
+static int check_kernel_copy(unsigned char *dst, unsigned char *src, unsigned char *ref,
+	size_t offset, size_t n)
+{
+	memset(dst, 0xEE, KERNEL_BUFFER);
+	memset(ref, 0xEE, KERNEL_BUFFER);
+	memcpy(ref + KERNEL_GUARD + offset, src + offset / 2, n);
+	if (ft_memcpy(dst + KERNEL_GUARD + offset, src + offset / 2, n) != dst + KERNEL_GUARD + offset)
+		return 0;
+	return memcmp(dst, ref, n + offset + 2 * KERNEL_GUARD) == 0;
+}
+
+static int check_kernel_set(unsigned char *dst, unsigned char *ref, size_t offset, size_t n)
+{
+	memset(dst, 0xEE, KERNEL_BUFFER);
+	memset(ref, 0xEE, KERNEL_BUFFER);
+	memset(ref + KERNEL_GUARD + offset, 0x5A, n);
+	if (ft_memset(dst + KERNEL_GUARD + offset, 0x15A, n) != dst + KERNEL_GUARD + offset)
+		return 0;
+	return memcmp(dst, ref, n + offset + 2 * KERNEL_GUARD) == 0;
+}
+
+static int check_kernel(unsigned char *dst, unsigned char *src, unsigned char *ref)
+{
+	static const size_t sizes[] = {0, 1, 7, 8, 15, 16, 17, 31, 32, 33, 63, 64, 65, 100,
+		255, 4096, 4099, 512 * 1024 - 1, 512 * 1024, 512 * 1024 + 45, (1 << 20) - 3};
+	static const size_t offsets[] = {0, 1, 7, 13, 31};
+
+	for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+		for (size_t j = 0; j < sizeof(offsets) / sizeof(offsets[0]); j++) {
+			if (!check_kernel_copy(dst, src, ref, offsets[j], sizes[i]) ||
+				!check_kernel_set(dst, ref, offsets[j], sizes[i]))
+				return 0;
+		}
+	}
+	return 1;
+}
+
+static int test_memory_kernels(void)
+{
+	unsigned char *dst = malloc(KERNEL_BUFFER);
+	unsigned char *src = malloc(KERNEL_BUFFER);
+	unsigned char *ref = malloc(KERNEL_BUFFER);
+	size_t selected = 0;
+	size_t len = sizeof(selected);
+	int tested = 0;
+	int ok = dst && src && ref &&
+		malloc_ctl("memory.kernel", &selected, &len, NULL, 0) == 0;
+
+	for (size_t i = 0; ok && i < KERNEL_BUFFER; i++)
+		src[i] = (unsigned char)(i * 31 + (i >> 8));
+	for (size_t kernel = 0; ok && kernel <= 2; kernel++) {
+		if (malloc_ctl("memory.kernel", NULL, NULL, &kernel, sizeof(kernel)) != 0)
+			continue;
+		tested++;
+		ok = check_kernel(dst, src, ref);
+	}
+
+	size_t bad = 3;
+	ok = ok && tested > 0 && malloc_ctl("memory.kernel", NULL, NULL, &bad, sizeof(bad)) != 0;
+	malloc_ctl("memory.kernel", NULL, NULL, &selected, sizeof(selected));
+	free(dst);
+	free(src);
+	free(ref);
+	return ok;
+}
+
+static const char *g_conf_probe_keys[] = {
+	"zone.tiny.max", "zone.small.max", "zone.tiny.size", "zone.small.size", "prof.sample"
+};
+
+static int conf_probe(void)
+{
+	char line[128];
+	size_t value;
+	size_t len;
+
+	for (size_t i = 0; i < sizeof(g_conf_probe_keys) / sizeof(g_conf_probe_keys[0]); i++) {
+		len = sizeof(value);
+		if (malloc_ctl(g_conf_probe_keys[i], &value, &len, NULL, 0) != 0)
+			return 1;
+		snprintf(line, sizeof(line), "%zu ", value);
+		print_str(line);
+	}
+	return 0;
+}
+
+static ssize_t read_all(int fd, char *buffer, size_t size)
+{
+	ssize_t total = 0;
+	ssize_t n;
+
+	while ((size_t)total < size - 1 && (n = read(fd, buffer + total, size - 1 - total)) > 0)
+		total += n;
+	buffer[total] = '\0';
+	return total;
+}
+
+static int run_conf(const char *conf, char *out, char *err, size_t size)
+{
+	int out_pipe[2];
+	int err_pipe[2];
+	int status;
+
+	if (pipe(out_pipe) != 0 || pipe(err_pipe) != 0)
+		return 0;
+	pid_t pid = fork();
+	if (pid == 0) {
+		dup2(out_pipe[1], 1);
+		dup2(err_pipe[1], 2);
+		setenv("MALLOC_CONF", conf, 1);
+		execl("/proc/self/exe", "test_complete", "--conf-probe", (char *)NULL);
+		_exit(127);
+	}
+	close(out_pipe[1]);
+	close(err_pipe[1]);
+	read_all(out_pipe[0], out, size);
+	read_all(err_pipe[0], err, size);
+	close(out_pipe[0]);
+	close(err_pipe[0]);
+	return pid > 0 && waitpid(pid, &status, 0) == pid && WIFEXITED(status) &&
+		WEXITSTATUS(status) == 0;
+}
+
+static int conf_case(const char *conf, const char *expected, const char *warning)
+{
+	char out[512];
+	char err[512];
+
+	if (!run_conf(conf, out, err, sizeof(out)) || strcmp(out, expected) != 0)
+		return 0;
+	return warning ? strstr(err, warning) != NULL : err[0] == '\0';
+}
+
+static int test_malloc_conf(void)
+{
+	return conf_case("zone.tiny.size:128k,zone.small.max=2048,zone.small.size:4M,prof.sample:1g",
+			"128 2048 131072 4194304 1073741824 ", NULL) &&
+		conf_case("zone.tiny.size:128K,prof.sample:99999999999999999999",
+			"128 1024 131072 425984 0 ", "invalid value: prof.sample:99999999999999999999") &&
+		conf_case("zone.small.size:17179869184g",
+			"128 1024 65536 425984 0 ", "invalid value: zone.small.size:17179869184g") &&
+		conf_case("zone.huge.max:5,zone.tiny.size:128k",
+			"128 1024 131072 425984 0 ", "unknown option: zone.huge.max:5") &&
+		conf_case("zone.tiny.size,zone.small.max:2048",
+			"128 2048 65536 425984 0 ", "malformed option: zone.tiny.size") &&
+		conf_case("zone.tiny.size:12x,prof.sample:k",
+			"128 1024 65536 425984 0 ", "invalid value: zone.tiny.size:12x") &&
+		conf_case("zone.tiny.size:128k,zone.tiny.max:2048,zone.small.max:1024",
+			"128 1024 65536 425984 0 ", "inconsistent settings, using defaults");
+}
+
+#define CTL_SWAP_THREADS 4
+#define CTL_SWAP_ROUNDS 200
+#define MAX_ZONES_PER_TYPE_TEST 1000
+
+static void *ctl_swap_worker(void *arg)
+{
+	size_t *olds = arg;
+	size_t base = olds[0];
+
+	for (size_t i = 0; i < CTL_SWAP_ROUNDS; i++) {
+		size_t value = base + i;
+		size_t len = sizeof(olds[i]);
+
+		if (malloc_ctl("zone.search_limit", &olds[i], &len, &value, sizeof(value)) != 0)
+			olds[i] = 0;
+	}
+	return NULL;
+}
+
+static int test_malloc_ctl_exchange(void)
+{
+	static size_t olds[CTL_SWAP_THREADS][CTL_SWAP_ROUNDS];
+	int counts[MAX_ZONES_PER_TYPE_TEST + 1] = {0};
+	pthread_t threads[CTL_SWAP_THREADS];
+	size_t initial;
+	size_t final;
+	size_t len = sizeof(initial);
+	int ok;
+
+	if (malloc_ctl("zone.search_limit", &initial, &len, NULL, 0) != 0)
+		return 0;
+	for (int t = 0; t < CTL_SWAP_THREADS; t++) {
+		olds[t][0] = 1 + (size_t)t * CTL_SWAP_ROUNDS;
+		pthread_create(&threads[t], NULL, ctl_swap_worker, olds[t]);
+	}
+	for (int t = 0; t < CTL_SWAP_THREADS; t++)
+		pthread_join(threads[t], NULL);
+	len = sizeof(final);
+	malloc_ctl("zone.search_limit", &final, &len, &initial, sizeof(initial));
+
+	counts[final]++;
+	for (int t = 0; t < CTL_SWAP_THREADS; t++) {
+		for (int i = 0; i < CTL_SWAP_ROUNDS; i++)
+			counts[olds[t][i] <= MAX_ZONES_PER_TYPE_TEST ? olds[t][i] : 0]++;
+	}
+	counts[initial]--;
+	ok = counts[0] == 0;
+	for (int v = 1; v <= CTL_SWAP_THREADS * CTL_SWAP_ROUNDS; v++)
+		ok = ok && counts[v] == 1;
+	return ok;
+}
+
+static int test_malloc_ctl(void)
+{
+	size_t old_value = 0;
+	size_t len = sizeof(old_value);
+	size_t new_value = 256;
+	size_t bad_value = 100;
+	size_t count = 0;
+
+	if (malloc_ctl("zone.tiny.max", &old_value, &len, &new_value, sizeof(new_value)) != 0)
+		return 0;
+	if (old_value != 128)
+		return 0;
+	if (malloc_ctl("zone.tiny.max", NULL, NULL, &bad_value, sizeof(bad_value)) == 0)
+		return 0;
+
+	void *ptr = malloc(200);
+	len = sizeof(count);
+	int ok = (ptr && malloc_ctl("zone.tiny.count", &count, &len, NULL, 0) == 0 && count > 0);
+
+	free(ptr);
+	malloc_ctl("zone.tiny.max", NULL, NULL, &old_value, sizeof(old_value));
+	if (malloc_ctl("no.such.key", NULL, NULL, NULL, 0) == 0)
+		return 0;
+	size_t released = SIZE_MAX;
+	len = sizeof(released);
+	return ok && malloc_ctl("arena.purge", &released, &len, NULL, 0) == 0 &&
+		released != SIZE_MAX;
+}
+
+static int test_malloc_trim(void)
+{
+	size_t old_max = 0;
+	size_t old_size = 0;
+	size_t len = sizeof(size_t);
+	size_t new_max = 8192;
+	size_t new_size = 512 * 4096;
+	t_malloc_trim_report report;
+
+	malloc_ctl("zone.small.size", &old_size, &len, &new_size, sizeof(new_size));
+	malloc_ctl("zone.small.max", &old_max, &len, &new_max, sizeof(new_max));
+
+	void *keep = malloc(8000);
+	void *hole = malloc(8000);
+	if (!keep || !hole)
+		return 0;
+
+	free(hole);
+	malloc_trim_ex(0, &report);
+	int purged = (report.bytes_purged[1] >= 4096 &&
+		report.bytes_released >= report.bytes_purged[1]);
+
+	free(keep);
+	malloc_trim_ex(0, &report);
+	int released = (report.zones_released[1] >= 1);
+
+	malloc_ctl("zone.small.max", NULL, NULL, &old_max, sizeof(old_max));
+	malloc_ctl("zone.small.size", NULL, NULL, &old_size, sizeof(old_size));
+	return purged && released;
+}
+
+int main(int argc, char **argv)
 {
 	int passed = 0;
 	int total = 0;
 
+	if (argc == 2 && strcmp(argv[1], "--conf-probe") == 0)
+		return conf_probe();
+
 	print_str("\n");
 	print_str("=================================================\n");
 	print_str("          MALLOC COMPREHENSIVE TEST SUITE        \n");
@@ -318,6 +1463,9 @@ int main(void)
 	total++; if (test_realloc_grow()) passed++;
 	print_result("  realloc grow", test_realloc_grow());
 
+	total++; if (test_realloc_copy_large()) passed++;
+	print_result("  realloc grow preserves 1 MB", test_realloc_copy_large());
+
 	total++; if (test_realloc_shrink()) passed++;
 	print_result("  realloc shrink", test_realloc_shrink());
 
@@ -325,6 +1473,9 @@ int main(void)
 	total++; if (test_alignment()) passed++;
 	print_result("  16-byte alignment", test_alignment());
 
+	total++; if (test_malloc_aligned()) passed++;
+	print_result("  malloc_aligned()/free_sized()", test_malloc_aligned());
+
 	total++; if (test_double_free_protection()) passed++;
 	print_result("  double-free protection", test_double_free_protection());
 
@@ -335,10 +1486,19 @@ int main(void)
 	total++; if (test_show_alloc_mem()) passed++;
 	print_result("  show_alloc_mem()", test_show_alloc_mem());
 
+	total++; if (test_show_alloc_mem_fd()) passed++;
+	print_result("  show_alloc_mem_fd() JSON/binary", test_show_alloc_mem_fd());
+
+	total++; if (test_heap_snapshot()) passed++;
+	print_result("  heap_snapshot() binary dump", test_heap_snapshot());
+
 	print_str("\nCleanup Functions:\n");
 	total++; if (test_malloc_cleanup()) passed++;
 	print_result("  malloc_cleanup()", test_malloc_cleanup());
 
+	total++; if (test_malloc_trim()) passed++;
+	print_result("  malloc_trim() purge and release", test_malloc_trim());
+
 	print_str("\nStress Tests:\n");
 	total++; if (test_stress_tiny()) passed++;
 	print_result("  100 TINY allocs", test_stress_tiny());
@@ -349,9 +1509,77 @@ int main(void)
 	total++; if (test_stress_large()) passed++;
 	print_result("  20 LARGE allocs", test_stress_large());
 
+	total++; if (test_many_large_zones()) passed++;
+	print_result("  1100 live LARGE allocs", test_many_large_zones());
+
 	total++; if (test_fragmentation()) passed++;
 	print_result("  fragmentation handling", test_fragmentation());
 
+	print_str("\nStatistics:\n");
+	total++; if (test_stats_counters()) passed++;
+	print_result("  incremental get_malloc_stats()", test_stats_counters());
+
+	total++; if (test_size_classes()) passed++;
+	print_result("  per-size-class histogram", test_size_classes());
+	total++; if (test_fragmentation_report()) passed++;
+	print_result("  external fragmentation report", test_fragmentation_report());
+	total++; if (test_residency()) passed++;
+	print_result("  resident memory via mincore", test_residency());
+	total++; if (test_vm_counters()) passed++;
+	print_result("  mmap/munmap/madvise counters", test_vm_counters());
+	total++; if (test_stats_shm_page()) passed++;
+	print_result("  shared-memory statistics page", test_stats_shm_page());
+
+	total++; if (test_heap_profiler()) passed++;
+	print_result("  sampling heap profiler dump", test_heap_profiler());
+
+	total++; if (test_latency_histograms()) passed++;
+	print_result("  allocation latency histograms", test_latency_histograms());
+
+	total++; if (test_lock_stats()) passed++;
+	print_result("  lock contention counters", test_lock_stats());
+
+	total++; if (test_trace_recorder()) passed++;
+	print_result("  allocation trace recorder", test_trace_recorder());
+
+	total++; if (test_leak_report()) passed++;
+	print_result("  leak report by call site", test_leak_report());
+	total++; if (test_hooks()) passed++;
+	print_result("  allocation hooks", test_hooks());
+	total++; if (test_hook_slot_reuse()) passed++;
+	print_result("  hook slot not reused while running", test_hook_slot_reuse());
+	total++; if (test_hook_zone_drops()) passed++;
+	print_result("  dropped hook zone events", test_hook_zone_drops());
+
+	print_str("\nPer-thread stats:\n");
+	total++; if (test_thread_stats()) passed++;
+	print_result("  per-thread statistics", test_thread_stats());
+	total++; if (test_thread_slot_reuse()) passed++;
+	print_result("  thread stats slots recycled", test_thread_slot_reuse());
+
+	print_str("\nMemory kernels:\n");
+	total++; if (test_memory_kernels()) passed++;
+	print_result("  memcpy/memset kernels vs reference", test_memory_kernels());
+
+	print_str("\nRuntime Control:\n");
+	total++; if (test_malloc_conf()) passed++;
+	print_result("  MALLOC_CONF parsing", test_malloc_conf());
+	total++; if (test_malloc_ctl_exchange()) passed++;
+	print_result("  malloc_ctl() exchange is atomic", test_malloc_ctl_exchange());
+	total++; if (test_malloc_ctl()) passed++;
+	print_result("  malloc_ctl() tunables and actions", test_malloc_ctl());
+
+	print_str("\nObject Pools:\n");
+	total++; if (test_pool_alloc_free()) passed++;
+	print_result("  pool alloc/free reuse", test_pool_alloc_free());
+
+	total++; if (test_pool_invalid_free()) passed++;
+	print_result("  pool rejects foreign and double frees", test_pool_invalid_free());
+	total++; if (test_pool_many_slabs()) passed++;
+	print_result("  pool validates frees across many slabs", test_pool_many_slabs());
+	total++; if (test_pool_stats()) passed++;
+	print_result("  pool statistics", test_pool_stats());
+
 	print_str("\n");
 	print_str("=================================================\n");
 	print_str("Results: ");
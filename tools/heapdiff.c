@@ -0,0 +1,195 @@
+#include "../include/malloc.h"
+#include <stdio.h>
+#include <string.h>
+
+#define HEAPDIFF_TOP_SITES 20
+
+typedef struct {
+    t_malloc_heap_header header;
+    t_malloc_heap_record *records;
+} t_snapshot;
+
+typedef struct {
+    uint64_t site;
+    int64_t count;
+    int64_t bytes;
+} t_site_delta;
+
+static int load_snapshot(const char *path, t_snapshot *snap)
+{
+    FILE *file = fopen(path, "rb");
+
+    if (!file) {
+        perror(path);
+        return -1;
+    }
+
+    snap->records = NULL;
+    if (fread(&snap->header, sizeof(snap->header), 1, file) != 1 ||
+        memcmp(snap->header.magic, MALLOC_HEAP_MAGIC, 8) != 0 ||
+        snap->header.version != MALLOC_HEAP_VERSION ||
+        snap->header.record_size != sizeof(t_malloc_heap_record)) {
+        fprintf(stderr, "%s: not a heap snapshot\n", path);
+        fclose(file);
+        return -1;
+    }
+
+    size_t count = snap->header.record_count;
+    snap->records = calloc(count ? count : 1, sizeof(t_malloc_heap_record));
+    if (!snap->records || fread(snap->records, sizeof(t_malloc_heap_record),
+                                count, file) != count) {
+        fprintf(stderr, "%s: truncated snapshot\n", path);
+        free(snap->records);
+        fclose(file);
+        return -1;
+    }
+
+    fclose(file);
+    return 0;
+}
+
+static void class_totals(const t_snapshot *snap, int64_t *count, int64_t *bytes)
+{
+    for (size_t i = 0; i < snap->header.record_count; i++) {
+        size_t index = snap->records[i].size_class;
+        if (index >= MALLOC_SIZE_CLASSES)
+            index = MALLOC_SIZE_CLASSES - 1;
+        count[index]++;
+        bytes[index] += (int64_t)snap->records[i].size;
+    }
+}
+
+static void report_classes(const t_snapshot *before, const t_snapshot *after)
+{
+    int64_t count[2][MALLOC_SIZE_CLASSES] = {{0}};
+    int64_t bytes[2][MALLOC_SIZE_CLASSES] = {{0}};
+
+    class_totals(before, count[0], bytes[0]);
+    class_totals(after, count[1], bytes[1]);
+
+    printf("\nGrowth by size class:\n");
+    printf("  %-12s %12s %12s %14s %14s\n", "class", "count", "delta", "bytes", "delta");
+    for (size_t i = 0; i < MALLOC_SIZE_CLASSES; i++) {
+        if (count[0][i] == count[1][i] && bytes[0][i] == bytes[1][i])
+            continue;
+        printf("  <= %-9llu %12lld %+12lld %14lld %+14lld\n",
+               (unsigned long long)after->header.class_max[i],
+               (long long)count[1][i], (long long)(count[1][i] - count[0][i]),
+               (long long)bytes[1][i], (long long)(bytes[1][i] - bytes[0][i]));
+    }
+}
+
+static int compare_site(const void *a, const void *b)
+{
+    uint64_t left = ((const t_malloc_heap_record *)a)->site;
+    uint64_t right = ((const t_malloc_heap_record *)b)->site;
+
+    return (left > right) - (left < right);
+}
+
+static int compare_delta(const void *a, const void *b)
+{
+    int64_t left = ((const t_site_delta *)a)->bytes;
+    int64_t right = ((const t_site_delta *)b)->bytes;
+
+    return (left < right) - (left > right);
+}
+
+static size_t sum_site(const t_snapshot *snap, size_t i, uint64_t site,
+                       int sign, t_site_delta *delta)
+{
+    while (i < snap->header.record_count && snap->records[i].site == site) {
+        delta->count += sign;
+        delta->bytes += sign * (int64_t)snap->records[i].size;
+        i++;
+    }
+    return i;
+}
+
+static size_t site_deltas(t_snapshot *before, t_snapshot *after, t_site_delta *deltas)
+{
+    size_t used = 0;
+    size_t i = 0;
+    size_t j = 0;
+
+    qsort(before->records, before->header.record_count,
+          sizeof(t_malloc_heap_record), compare_site);
+    qsort(after->records, after->header.record_count,
+          sizeof(t_malloc_heap_record), compare_site);
+
+    while (i < before->header.record_count || j < after->header.record_count) {
+        uint64_t site;
+
+        if (j == after->header.record_count ||
+            (i < before->header.record_count &&
+             before->records[i].site < after->records[j].site))
+            site = before->records[i].site;
+        else
+            site = after->records[j].site;
+
+        t_site_delta *delta = &deltas[used++];
+        delta->site = site;
+        delta->count = 0;
+        delta->bytes = 0;
+        i = sum_site(before, i, site, -1, delta);
+        j = sum_site(after, j, site, 1, delta);
+    }
+    return used;
+}
+
+static void report_sites(t_snapshot *before, t_snapshot *after)
+{
+    size_t capacity = before->header.record_count + after->header.record_count + 1;
+    t_site_delta *deltas = calloc(capacity, sizeof(t_site_delta));
+
+    if (!deltas)
+        return;
+
+    size_t used = site_deltas(before, after, deltas);
+    qsort(deltas, used, sizeof(t_site_delta), compare_delta);
+
+    printf("\nGrowth by allocation site (top %d):\n", HEAPDIFF_TOP_SITES);
+    for (size_t i = 0; i < used && i < HEAPDIFF_TOP_SITES; i++) {
+        if (deltas[i].count == 0 && deltas[i].bytes == 0)
+            continue;
+        if (deltas[i].site)
+            printf("  0x%-16llx", (unsigned long long)deltas[i].site);
+        else
+            printf("  %-18s", "(unknown)");
+        printf(" %+10lld allocations %+14lld bytes\n",
+               (long long)deltas[i].count, (long long)deltas[i].bytes);
+    }
+    free(deltas);
+}
+
+int main(int argc, char **argv)
+{
+    t_snapshot before;
+    t_snapshot after;
+
+    if (argc != 3) {
+        fprintf(stderr, "usage: %s <before.snap> <after.snap>\n", argv[0]);
+        return 2;
+    }
+
+    if (load_snapshot(argv[1], &before) != 0)
+        return 1;
+    if (load_snapshot(argv[2], &after) != 0) {
+        free(before.records);
+        return 1;
+    }
+
+    printf("before: %llu allocations, %llu bytes\n",
+           (unsigned long long)before.header.record_count,
+           (unsigned long long)before.header.live_bytes);
+    printf("after:  %llu allocations, %llu bytes\n",
+           (unsigned long long)after.header.record_count,
+           (unsigned long long)after.header.live_bytes);
+
+    report_classes(&before, &after);
+    report_sites(&before, &after);
+
+    free(before.records);
+    free(after.records);
+    return 0;
+}
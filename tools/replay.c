@@ -0,0 +1,275 @@
+#define _GNU_SOURCE
+#include "../include/malloc.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+typedef struct {
+    uint64_t id;
+    void *ptr;
+} t_live_entry;
+
+typedef struct {
+    t_live_entry *slots;
+    size_t mask;
+} t_live_table;
+
+typedef struct {
+    uint64_t *samples[3];
+    size_t count[3];
+} t_latencies;
+
+static void *map_zeroed(size_t size)
+{
+    void *ptr = mmap(NULL, size ? size : 1, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return ptr == MAP_FAILED ? NULL : ptr;
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static int key_less(uint64_t a, uint64_t b, const t_malloc_trace_record *records)
+{
+    if (records && records[a].timestamp != records[b].timestamp)
+        return records[a].timestamp < records[b].timestamp;
+    return a < b;
+}
+
+static void sift_down(uint64_t *keys, size_t root, size_t n,
+                      const t_malloc_trace_record *records)
+{
+    while (root * 2 + 1 < n) {
+        size_t child = root * 2 + 1;
+        if (child + 1 < n && key_less(keys[child], keys[child + 1], records))
+            child++;
+        if (!key_less(keys[root], keys[child], records))
+            return;
+        uint64_t tmp = keys[root];
+        keys[root] = keys[child];
+        keys[child] = tmp;
+        root = child;
+    }
+}
+
+static void sort_keys(uint64_t *keys, size_t n, const t_malloc_trace_record *records)
+{
+    for (size_t i = n / 2; i > 0; i--)
+        sift_down(keys, i - 1, n, records);
+    for (size_t end = n; end > 1; end--) {
+        uint64_t tmp = keys[0];
+        keys[0] = keys[end - 1];
+        keys[end - 1] = tmp;
+        sift_down(keys, 0, end - 1, records);
+    }
+}
+
+static size_t live_find(const t_live_table *table, uint64_t id)
+{
+    size_t index = (size_t)((id >> 4) * 0x9E3779B97F4A7C15ULL) & table->mask;
+
+    while (table->slots[index].id && table->slots[index].id != id)
+        index = (index + 1) & table->mask;
+    return index;
+}
+
+static void live_remove(t_live_table *table, size_t hole)
+{
+    size_t next = hole;
+
+    table->slots[hole].id = 0;
+    while (table->slots[(next = (next + 1) & table->mask)].id) {
+        t_live_entry entry = table->slots[next];
+        table->slots[next].id = 0;
+        table->slots[live_find(table, entry.id)] = entry;
+    }
+}
+
+static void *take_live(t_live_table *table, uint64_t id)
+{
+    size_t index = live_find(table, id);
+    void *ptr = table->slots[index].ptr;
+
+    if (!table->slots[index].id)
+        return NULL;
+    live_remove(table, index);
+    return ptr;
+}
+
+static int put_live(t_live_table *table, uint64_t id, void *ptr)
+{
+    if (!id || !ptr)
+        return 0;
+    size_t index = live_find(table, id);
+    if (table->slots[index].id)
+        return -1;
+    table->slots[index].id = id;
+    table->slots[index].ptr = ptr;
+    ((volatile char *)ptr)[0] = 1;
+    return 0;
+}
+
+static int replay_one(const t_malloc_trace_record *record, t_live_table *table)
+{
+    if (record->op == MALLOC_OP_MALLOC)
+        return put_live(table, record->ptr, malloc(record->size));
+    if (record->op == MALLOC_OP_FREE) {
+        free(take_live(table, record->old_ptr));
+        return 0;
+    }
+    void *old = take_live(table, record->old_ptr);
+    return put_live(table, record->ptr, realloc(old, record->size));
+}
+
+static size_t rss_kb(void)
+{
+    char buffer[64];
+    long pages = 0;
+    long resident = 0;
+    int fd = open("/proc/self/statm", O_RDONLY);
+
+    if (fd < 0)
+        return 0;
+    ssize_t len = read(fd, buffer, sizeof(buffer) - 1);
+    close(fd);
+    if (len <= 0)
+        return 0;
+    buffer[len] = '\0';
+    if (sscanf(buffer, "%ld %ld", &pages, &resident) != 2)
+        return 0;
+    return (size_t)resident * (size_t)sysconf(_SC_PAGESIZE) / 1024;
+}
+
+static void report_op(const char *name, uint64_t *samples, size_t count)
+{
+    if (count == 0)
+        return;
+
+    sort_keys(samples, count, NULL);
+    printf("  %-8s %10zu ops  p50 %8llu ns  p99 %8llu ns  p99.9 %8llu ns  max %10llu ns\n",
+           name, count,
+           (unsigned long long)samples[count / 2],
+           (unsigned long long)samples[count * 99 / 100],
+           (unsigned long long)samples[count * 999 / 1000],
+           (unsigned long long)samples[count - 1]);
+}
+
+static int run_trace(const t_malloc_trace_record *records, const uint64_t *order,
+                     size_t count, t_live_table *table, t_latencies *lat,
+                     uint64_t *elapsed)
+{
+    uint64_t begin = now_ns();
+
+    for (size_t i = 0; i < count; i++) {
+        const t_malloc_trace_record *record = &records[order[i]];
+        uint32_t op = record->op < 3 ? record->op : MALLOC_OP_REALLOC;
+        uint64_t start = now_ns();
+
+        if (replay_one(record, table) != 0) {
+            fprintf(stderr, "replay: record %llu allocates id %#llx that is still live\n",
+                    (unsigned long long)order[i], (unsigned long long)record->ptr);
+            return -1;
+        }
+        lat->samples[op][lat->count[op]++] = now_ns() - start;
+    }
+    *elapsed = now_ns() - begin;
+    return 0;
+}
+
+static int load_trace(const char *path, const t_malloc_trace_record **records,
+                      size_t *count)
+{
+    struct stat st;
+    int fd = open(path, O_RDONLY);
+
+    if (fd < 0 || fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(t_malloc_trace_header)) {
+        perror(path);
+        if (fd >= 0)
+            close(fd);
+        return -1;
+    }
+
+    const t_malloc_trace_header *header = mmap(NULL, (size_t)st.st_size, PROT_READ,
+                                               MAP_PRIVATE | MAP_POPULATE, fd, 0);
+    close(fd);
+    if (header == MAP_FAILED || memcmp(header->magic, MALLOC_TRACE_MAGIC, 8) != 0 ||
+        header->record_size != sizeof(t_malloc_trace_record)) {
+        fprintf(stderr, "%s: not an allocation trace\n", path);
+        return -1;
+    }
+
+    *records = (const t_malloc_trace_record *)(header + 1);
+    *count = ((size_t)st.st_size - sizeof(*header)) / sizeof(t_malloc_trace_record);
+    return 0;
+}
+
+static int setup(size_t count, uint64_t **order, t_live_table *table, t_latencies *lat)
+{
+    size_t capacity = 16;
+
+    while (capacity < count * 2)
+        capacity *= 2;
+
+    *order = map_zeroed(count * sizeof(uint64_t));
+    table->slots = map_zeroed(capacity * sizeof(t_live_entry));
+    table->mask = capacity - 1;
+    for (int op = 0; op < 3; op++) {
+        lat->samples[op] = map_zeroed(count * sizeof(uint64_t));
+        lat->count[op] = 0;
+        if (!lat->samples[op])
+            return -1;
+    }
+    if (!*order || !table->slots)
+        return -1;
+
+    for (size_t i = 0; i < count; i++)
+        (*order)[i] = i;
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    const t_malloc_trace_record *records;
+    t_live_table table;
+    t_latencies lat;
+    uint64_t *order;
+    uint64_t elapsed;
+    size_t count;
+    struct rusage usage;
+
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s <trace>\n", argv[0]);
+        return 2;
+    }
+
+    if (load_trace(argv[1], &records, &count) != 0)
+        return 1;
+    if (setup(count, &order, &table, &lat) != 0) {
+        fprintf(stderr, "replay: out of memory\n");
+        return 1;
+    }
+
+    sort_keys(order, count, records);
+    size_t rss_before = rss_kb();
+    if (run_trace(records, order, count, &table, &lat, &elapsed) != 0)
+        return 1;
+    getrusage(RUSAGE_SELF, &usage);
+
+    printf("replayed %zu operations in %.3f ms (%.0f ops/sec)\n", count,
+           (double)elapsed / 1e6, elapsed ? (double)count * 1e9 / (double)elapsed : 0.0);
+    report_op("malloc", lat.samples[MALLOC_OP_MALLOC], lat.count[MALLOC_OP_MALLOC]);
+    report_op("free", lat.samples[MALLOC_OP_FREE], lat.count[MALLOC_OP_FREE]);
+    report_op("realloc", lat.samples[MALLOC_OP_REALLOC], lat.count[MALLOC_OP_REALLOC]);
+    printf("peak RSS %ld KB (%zu KB before replay)\n", usage.ru_maxrss, rss_before);
+    return 0;
+}
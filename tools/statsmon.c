@@ -0,0 +1,101 @@
+#define _GNU_SOURCE
+#include "../include/malloc.h"
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define READ_RETRIES 1000
+
+static const t_malloc_stats_page *open_page(const char *name)
+{
+    char path[256];
+    struct stat st;
+
+    snprintf(path, sizeof(path), "%s%s", strchr(name, '/') ? "" : "/dev/shm/", name);
+    int fd = open(path, O_RDONLY);
+    if (fd < 0 || fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(t_malloc_stats_page)) {
+        perror(path);
+        if (fd >= 0)
+            close(fd);
+        return NULL;
+    }
+
+    const t_malloc_stats_page *page = mmap(NULL, sizeof(*page), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (page == MAP_FAILED || memcmp(page->magic, MALLOC_STATS_SHM_MAGIC, 8) != 0 ||
+        page->version != MALLOC_STATS_SHM_VERSION) {
+        fprintf(stderr, "%s: not an allocator statistics page\n", path);
+        return NULL;
+    }
+    return page;
+}
+
+static int read_page(const t_malloc_stats_page *page, t_malloc_stats_page *copy)
+{
+    for (int retry = 0; retry < READ_RETRIES; retry++) {
+        uint64_t before = __atomic_load_n(&page->sequence, __ATOMIC_ACQUIRE);
+        if (before & 1)
+            continue;
+        memcpy(copy, page, sizeof(*copy));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&page->sequence, __ATOMIC_RELAXED) == before)
+            return 0;
+    }
+    return -1;
+}
+
+static double hit_rate(uint64_t hits, uint64_t misses)
+{
+    return hits + misses ? 100.0 * (double)hits / (double)(hits + misses) : 0.0;
+}
+
+static void print_page(const t_malloc_stats_page *s)
+{
+    printf("pid %llu  allocated %llu  peak %llu  mapped %llu\n",
+           (unsigned long long)s->pid, (unsigned long long)s->bytes_allocated,
+           (unsigned long long)s->bytes_peak, (unsigned long long)s->bytes_mapped);
+    printf("  zones %llu (tiny %llu, small %llu, large %llu)  mmap %llu  munmap %llu\n",
+           (unsigned long long)s->zones_active, (unsigned long long)s->zones_by_type[0],
+           (unsigned long long)s->zones_by_type[1], (unsigned long long)s->zones_by_type[2],
+           (unsigned long long)s->mmap_calls, (unsigned long long)s->munmap_calls);
+    printf("  free-chunk reuse %.1f%% (%llu hits, %llu misses)  errors %llu\n",
+           hit_rate(s->reuse_hits, s->reuse_misses), (unsigned long long)s->reuse_hits,
+           (unsigned long long)s->reuse_misses, (unsigned long long)s->errors_count);
+    fflush(stdout);
+}
+
+int main(int argc, char **argv)
+{
+    t_malloc_stats_page copy;
+
+    if (argc < 2 || argc > 3) {
+        fprintf(stderr, "usage: %s <name|path> [interval_ms]\n", argv[0]);
+        return 2;
+    }
+
+    const t_malloc_stats_page *page = open_page(argv[1]);
+    if (!page)
+        return 1;
+
+    long interval = argc == 3 ? atol(argv[2]) : 0;
+    struct timespec delay = {interval / 1000, (interval % 1000) * 1000000L};
+
+    do {
+        if (read_page(page, &copy) != 0) {
+            fprintf(stderr, "statsmon: page is being rewritten too fast\n");
+            return 1;
+        }
+        print_page(&copy);
+        if (interval > 0 && kill((pid_t)copy.pid, 0) != 0) {
+            fprintf(stderr, "statsmon: process %llu has exited\n", (unsigned long long)copy.pid);
+            return 0;
+        }
+    } while (interval > 0 && nanosleep(&delay, NULL) == 0);
+    return 0;
+}